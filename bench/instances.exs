@@ -0,0 +1,51 @@
+# Import and solve external OPB and MPS instances.
+#
+#     mix bench.instances [--time-limit 60] [--output results.json] file.opb file.mps ...
+#
+# The format is taken from the file extension. The results are written as
+# JSON, one entry per instance under "runs", with the import and solve time,
+# the peak RSS and the size of the imported model.
+
+Code.require_file("support/bench.exs", __DIR__)
+
+defmodule Exhort.Bench.Instances do
+  @moduledoc false
+
+  alias Exhort.NativeMemory
+  alias Exhort.SAT.Model
+
+  def run(path, time_limit) do
+    format = format(path)
+    before = NativeMemory.report().rss
+
+    {import_us, {:ok, model}} = :timer.tc(fn -> Model.from_file(path, format) end)
+    imported = NativeMemory.report().rss
+
+    {solve_us, response} = :timer.tc(fn -> Model.solve(model, time_limit: time_limit) end)
+
+    %{
+      "name" => Path.basename(path),
+      "format" => Atom.to_string(format),
+      "variables" => map_size(model.vars.map),
+      "import_us" => import_us,
+      "import_rss_bytes" => max(imported - before, 0),
+      "solve_us" => solve_us,
+      "status" => Atom.to_string(response.status),
+      "objective" => response.objective
+    }
+  end
+
+  defp format(path) do
+    case path |> Path.extname() |> String.downcase() do
+      ".opb" -> :opb
+      ".mps" -> :mps
+      ext -> raise ArgumentError, "unknown instance format #{inspect(ext)}"
+    end
+  end
+end
+
+{opts, paths} = OptionParser.parse!(System.argv(), strict: [output: :string, time_limit: :integer])
+
+runs = Enum.map(paths, &Exhort.Bench.Instances.run(&1, Keyword.get(opts, :time_limit, 60)))
+
+Exhort.Bench.write(%{"environment" => Exhort.Bench.environment(), "runs" => runs}, opts[:output])
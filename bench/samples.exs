@@ -0,0 +1,50 @@
+# Benchmark the sample models, splitting DSL, marshalling and solve time.
+#
+#     mix bench [--iterations 5] [--only n_queens,knapsack] [--output results.json]
+#       [--save runs.etf] [--baseline runs.etf]
+#
+# The results are written as JSON, one entry per sample under "runs".
+#
+# `--save` also stores the runs as an Erlang term file. `--baseline` compares
+# the runs with such a file, for example one saved with another build of the
+# NIFs (see `make speedup`), and adds the "speedup" of each phase to each run.
+
+Code.require_file("support/bench.exs", __DIR__)
+Code.require_file("../test/support/sample_models.ex", __DIR__)
+
+defmodule Exhort.Bench.Samples do
+  @moduledoc false
+
+  # The models are shared with the sample tests in `Exhort.SampleModels`.
+
+  alias Exhort.SampleModels
+
+  # Both encodings of the same travelling salesman tour.
+  @routing_points for node <- 0..29, do: {rem(node * 37, 101), rem(node * 59, 97)}
+
+  def samples do
+    [
+      {"n_queens", &SampleModels.n_queens/0},
+      {"job_shop", &SampleModels.job_shop/0},
+      {"nurse_scheduling", &SampleModels.nurse_scheduling/0},
+      {"knapsack", &SampleModels.knapsack/0},
+      {"bin_packing", &SampleModels.bin_packing/0},
+      {"routing_circuit", fn -> SampleModels.routing_circuit(@routing_points) end},
+      {"routing_mtz", fn -> SampleModels.routing_mtz(@routing_points) end}
+    ]
+  end
+end
+
+options = Exhort.Bench.options(System.argv())
+
+runs =
+  for {name, fun} <- Exhort.Bench.Samples.samples(),
+      options.only == nil or name in options.only do
+    Exhort.Bench.run(name, fun, options.iterations)
+  end
+
+if options.save, do: Exhort.Bench.save(runs, options.save)
+
+runs = if options.baseline, do: Exhort.Bench.compare(runs, options.baseline), else: runs
+
+Exhort.Bench.write(%{"environment" => Exhort.Bench.environment(), "runs" => runs}, options.output)
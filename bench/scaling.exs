@@ -0,0 +1,246 @@
+# Scale synthetic models from thousands to millions of variables and flag
+# where building them grows superlinearly.
+#
+#     mix bench.scaling [--sizes 1000,10000,100000,1000000]
+#       [--only assignment,scheduling,knapsack,incremental] [--time-limit 10]
+#       [--threshold 1.2] [--output scaling.json]
+#
+# For each family and size the time spent in the DSL, the build time (DSL and
+# `Builder.build/1`), peak RSS and its growth over the RSS before the build,
+# NIF resource count and solve time are recorded. Between consecutive
+# sizes the growth exponent of each metric is log(m2 / m1) / log(n2 / n1);
+# a metric is flagged as superlinear when its exponent exceeds the threshold.
+
+Code.require_file("support/bench.exs", __DIR__)
+
+defmodule Exhort.Bench.Scaling do
+  @moduledoc false
+
+  use Exhort.SAT.Builder
+
+  alias Exhort.Bench
+
+  # The metrics expected to grow linearly with the number of variables. The
+  # solve time is reported but not flagged, it depends on the search.
+  @linear_metrics ~w(dsl_us build_us rss_growth resources)
+
+  def families do
+    [
+      {"assignment", &assignment/1},
+      {"scheduling", &scheduling/1},
+      {"knapsack", &knapsack/1},
+      {"incremental", &incremental/1}
+    ]
+  end
+
+  @doc """
+  Assign `sqrt(n)` tasks to `sqrt(n)` workers, one boolean per pair, with a
+  cost per pair to minimize.
+  """
+  def assignment(n) do
+    size = max(round(:math.sqrt(n)), 2)
+    all = 0..(size - 1)
+    x = fn worker, task -> "x_#{worker}_#{task}" end
+
+    vars = for w <- all, t <- all, do: BoolVar.new(x.(w, t))
+
+    one_worker =
+      for t <- all do
+        Constraint.new(sum(for w <- all, do: x.(w, t)) == 1)
+      end
+
+    one_task =
+      for w <- all do
+        Constraint.new(sum(for t <- all, do: x.(w, t)) <= 1)
+      end
+
+    cost = for w <- all, t <- all, do: LinearExpression.prod(x.(w, t), rem(w * 31 + t * 17, 100))
+
+    Builder.new()
+    |> Builder.add(vars)
+    |> Builder.add(one_worker)
+    |> Builder.add(one_task)
+    |> Builder.minimize(sum(cost))
+  end
+
+  @doc """
+  Schedule `n / 2` tasks, each with a start and an end, on machines of 100
+  tasks that may not overlap, minimizing the makespan.
+  """
+  def scheduling(n) do
+    num_tasks = max(div(n, 2), 2)
+    tasks = 0..(num_tasks - 1)
+    duration = fn task -> rem(task * 7, 10) + 1 end
+    horizon = Enum.reduce(tasks, 0, &(duration.(&1) + &2))
+
+    task_vars =
+      Enum.flat_map(tasks, fn task ->
+        [
+          IntVar.new("start_#{task}", {0, horizon}),
+          IntVar.new("end_#{task}", {0, horizon}),
+          IntervalVar.new("interval_#{task}", "start_#{task}", duration.(task), "end_#{task}")
+        ]
+      end)
+
+    machines =
+      tasks
+      |> Enum.chunk_every(100)
+      |> Enum.map(fn chunk -> Constraint.no_overlap(Enum.map(chunk, &"interval_#{&1}")) end)
+
+    Builder.new()
+    |> Builder.add(task_vars)
+    |> Builder.add(machines)
+    |> Builder.def_int_var("makespan", {0, horizon})
+    |> Builder.max_equality("makespan", Enum.map(tasks, &"end_#{&1}"))
+    |> Builder.minimize("makespan")
+  end
+
+  @doc """
+  Pick among `n` items under a single capacity, maximizing their value.
+  """
+  def knapsack(n) do
+    items = 0..(n - 1)
+    weight = fn item -> rem(item * 13, 50) + 1 end
+    value = fn item -> rem(item * 29, 70) + 1 end
+    capacity = div(Enum.reduce(items, 0, &(weight.(&1) + &2)), 4)
+
+    vars = Enum.map(items, &BoolVar.new("item_#{&1}"))
+    load = Enum.map(items, &LinearExpression.prod("item_#{&1}", weight.(&1)))
+    total = Enum.map(items, &LinearExpression.prod("item_#{&1}", value.(&1)))
+
+    Builder.new()
+    |> Builder.add(vars)
+    |> Builder.constrain(sum(load) <= capacity)
+    |> Builder.maximize(sum(total))
+  end
+
+  @doc """
+  Define `n` variables and `n` constraints one at a time, the way models are
+  usually accumulated, so that the cost of growing the builder shows.
+  """
+  def incremental(n) do
+    Enum.reduce(0..(n - 1), Builder.new(), fn item, builder ->
+      builder
+      |> Builder.def_int_var("x_#{item}", {0, 10})
+      |> Builder.constrain("x_#{item}", :<=, rem(item, 10))
+    end)
+  end
+
+  def measure(family, fun, n, time_limit) do
+    :erlang.garbage_collect()
+    baseline = Exhort.NativeMemory.report().rss
+
+    {%{model: model, resources: resources, dsl_us: dsl_us, build_us: build_us}, peak_rss} =
+      Bench.peak_rss(fn ->
+        {dsl_us, builder} = :timer.tc(fn -> fun.(n) end)
+
+        {build_us, {model, resources}} =
+          :timer.tc(fn -> Bench.allocated(fn -> Builder.build(builder) end) end)
+
+        %{model: model, resources: resources, dsl_us: dsl_us, build_us: dsl_us + build_us}
+      end)
+
+    {solve_us, response} = :timer.tc(fn -> Model.solve(model, time_limit: time_limit) end)
+
+    %{
+      "family" => family,
+      "size" => n,
+      "variables" => Enum.count(model.vars.map),
+      "dsl_us" => dsl_us,
+      "build_us" => build_us,
+      "peak_rss" => peak_rss,
+      "rss_growth" => peak_rss - baseline,
+      "resources" => resources,
+      "solve_us" => solve_us,
+      "status" => Atom.to_string(response.status)
+    }
+  end
+
+  @doc """
+  Annotate each result with the growth exponents since the previous size and
+  the metrics that grew superlinearly.
+  """
+  def growth(results, threshold) do
+    [nil | results]
+    |> Enum.zip(results)
+    |> Enum.map(fn
+      {nil, result} ->
+        Map.merge(result, %{"growth" => %{}, "superlinear" => []})
+
+      {previous, result} ->
+        growth =
+          Map.new(@linear_metrics ++ ["solve_us"], fn metric ->
+            {metric, exponent(previous, result, metric)}
+          end)
+
+        superlinear =
+          Enum.filter(@linear_metrics, fn metric ->
+            is_float(growth[metric]) and growth[metric] > threshold
+          end)
+
+        Map.merge(result, %{"growth" => growth, "superlinear" => superlinear})
+    end)
+  end
+
+  defp exponent(previous, result, metric) do
+    m1 = previous[metric]
+    m2 = result[metric]
+    n1 = previous["variables"]
+    n2 = result["variables"]
+
+    if m1 > 0 and m2 > 0 and n2 > n1 do
+      Float.round(:math.log(m2 / m1) / :math.log(n2 / n1), 3)
+    end
+  end
+
+  def options(argv) do
+    {opts, _args} =
+      OptionParser.parse!(argv,
+        strict: [
+          sizes: :string,
+          only: :string,
+          time_limit: :integer,
+          threshold: :float,
+          output: :string
+        ]
+      )
+
+    %{
+      sizes:
+        (opts[:sizes] || "1000,10000,100000,1000000")
+        |> String.split(",")
+        |> Enum.map(&String.to_integer/1),
+      only: opts[:only] && String.split(opts[:only], ","),
+      time_limit: Keyword.get(opts, :time_limit, 10),
+      threshold: Keyword.get(opts, :threshold, 1.2),
+      output: opts[:output]
+    }
+  end
+end
+
+alias Exhort.Bench.Scaling
+
+options = Scaling.options(System.argv())
+
+runs =
+  for {family, fun} <- Scaling.families(),
+      options.only == nil or family in options.only do
+    options.sizes
+    |> Enum.map(&Scaling.measure(family, fun, &1, options.time_limit))
+    |> Scaling.growth(options.threshold)
+  end
+
+superlinear =
+  for run <- List.flatten(runs), run["superlinear"] != [] do
+    %{"family" => run["family"], "size" => run["size"], "metrics" => run["superlinear"]}
+  end
+
+Exhort.Bench.write(
+  %{
+    "environment" => Exhort.Bench.environment(),
+    "threshold" => options.threshold,
+    "runs" => List.flatten(runs),
+    "superlinear" => superlinear
+  },
+  options.output
+)
@@ -0,0 +1,280 @@
+defmodule Exhort.Bench do
+  @moduledoc false
+
+  # Measure where the time of building and solving a model goes.
+  #
+  # Each run is split into phases:
+  #
+  # - `dsl` - Running the builder pipeline, which is pure Elixir.
+  # - `resolve` - The Elixir part of `Builder.build/1`, resolving variables
+  #   and expressions.
+  # - `marshal` - The time spent in NIF calls during `Builder.build/1`.
+  # - `solve_overhead` - The part of `Model.solve/2` outside CP-SAT's own wall
+  #   time: `Build()`, copying the model and building the response.
+  # - `cp_sat` - CP-SAT's wall time as reported in the response.
+  #
+  # NIF calls are counted and timed with `:erlang.trace_pattern/3`, using the
+  # `call_count` and `call_time` flags, which send no trace messages. The
+  # resources allocated are read from `Exhort.NativeMemory.resources/0`.
+
+  alias Exhort.NIF.Nif
+  alias Exhort.SAT.Builder
+  alias Exhort.SAT.Model
+
+  @doc """
+  Run `fun`, which returns a `%Builder{}`, `iterations` times and report the
+  median of each phase, in microseconds, with the NIF calls of the last run.
+  """
+  def run(name, fun, iterations) do
+    runs = Enum.map(1..iterations, fn _ -> measure(fun) end)
+    last = List.last(runs)
+
+    %{
+      "name" => name,
+      "iterations" => iterations,
+      "phases_us" =>
+        Map.new(~w(dsl resolve marshal solve_overhead cp_sat total), fn phase ->
+          {phase, median(Enum.map(runs, & &1.phases[phase]))}
+        end),
+      "nif_calls" => last.nif_calls,
+      "nif_call_count" => last.nif_calls |> Map.values() |> Enum.sum(),
+      "resources" => last.resources,
+      "status" => Atom.to_string(last.response.status),
+      "objective" => last.response.objective
+    }
+  end
+
+  defp measure(fun) do
+    {{dsl, builder}, dsl_resources} = allocated(fn -> :timer.tc(fun) end)
+
+    {{build, {model, build_calls}}, build_resources} =
+      allocated(fn -> :timer.tc(fn -> traced(fn -> Builder.build(builder) end) end) end)
+
+    {{solve, {response, solve_calls}}, solve_resources} =
+      allocated(fn -> :timer.tc(fn -> traced(fn -> Model.solve(model) end) end) end)
+
+    marshal = build_calls |> Map.values() |> Enum.map(&elem(&1, 1)) |> Enum.sum()
+    cp_sat = round(response.walltime * 1_000_000)
+
+    nif_calls =
+      Map.merge(build_calls, solve_calls, fn _name, {c1, t1}, {c2, t2} -> {c1 + c2, t1 + t2} end)
+      |> Map.new(fn {name, {count, _time}} -> {name, count} end)
+
+    %{
+      phases: %{
+        "dsl" => dsl,
+        "resolve" => max(build - marshal, 0),
+        "marshal" => marshal,
+        "solve_overhead" => max(solve - cp_sat, 0),
+        "cp_sat" => cp_sat,
+        "total" => dsl + build + solve
+      },
+      nif_calls: nif_calls,
+      resources: dsl_resources + build_resources + solve_resources,
+      response: response
+    }
+  end
+
+  @doc """
+  Run `fun` while counting and timing the calls to each NIF. Returns the
+  result of `fun` with `%{name => {count, microseconds}}`.
+  """
+  def traced(fun) do
+    :erlang.trace_pattern({Nif, :_, :_}, true, [:call_count, :call_time])
+    :erlang.trace(self(), true, [:call])
+
+    try do
+      result = fun.()
+      {result, collect()}
+    after
+      :erlang.trace(self(), false, [:call])
+      :erlang.trace_pattern({Nif, :_, :_}, false, [:call_count, :call_time])
+    end
+  end
+
+  defp collect do
+    Nif.__info__(:functions)
+    |> Enum.flat_map(fn {name, arity} ->
+      {:call_count, count} = :erlang.trace_info({Nif, name, arity}, :call_count)
+      {:call_time, times} = :erlang.trace_info({Nif, name, arity}, :call_time)
+
+      time =
+        times
+        |> List.wrap()
+        |> Enum.map(fn {_pid, _count, s, us} -> s * 1_000_000 + us end)
+        |> Enum.sum()
+
+      if is_integer(count) and count > 0, do: [{Atom.to_string(name), {count, time}}], else: []
+    end)
+    |> Map.new()
+  end
+
+  @doc """
+  Run `fun` and count the native resources it allocated, from the native
+  resource counters. Returns the result of `fun` with the count.
+  """
+  def allocated(fun) do
+    before = allocated_resources()
+    result = fun.()
+    {result, allocated_resources() - before}
+  end
+
+  defp allocated_resources do
+    Exhort.NativeMemory.resources()
+    |> Map.values()
+    |> Enum.map(& &1.allocated)
+    |> Enum.sum()
+  end
+
+  @doc """
+  Run `fun` while sampling the resident set size of the node every
+  `interval` milliseconds. Returns the result of `fun` with the peak RSS in
+  bytes.
+  """
+  def peak_rss(fun, interval \\ 10) do
+    parent = self()
+    sampler = spawn_link(fn -> sample_rss(parent, interval, rss()) end)
+
+    try do
+      result = fun.()
+      send(sampler, :stop)
+
+      receive do
+        {:peak_rss, ^sampler, peak} -> {result, max(peak, rss())}
+      end
+    after
+      Process.unlink(sampler)
+      Process.exit(sampler, :kill)
+    end
+  end
+
+  defp sample_rss(parent, interval, peak) do
+    receive do
+      :stop -> send(parent, {:peak_rss, self(), peak})
+    after
+      interval -> sample_rss(parent, interval, max(peak, rss()))
+    end
+  end
+
+  defp rss, do: Exhort.NativeMemory.report().rss
+
+  defp median(values) do
+    values |> Enum.sort() |> Enum.at(div(length(values), 2))
+  end
+
+  @doc """
+  Write `results` as JSON to `path`, or print it when `path` is nil.
+  """
+  def write(results, nil), do: IO.puts(to_json(results))
+  def write(results, path), do: File.write!(path, to_json(results) <> "\n")
+
+  @doc """
+  Store `runs` as an Erlang term file at `path`, to be compared with later.
+  """
+  def save(runs, path) do
+    File.mkdir_p!(Path.dirname(path))
+    File.write!(path, :erlang.term_to_binary(runs))
+  end
+
+  @doc """
+  Add to each of `runs` the `speedup` of each phase over the run of the same
+  name saved at `baseline_path`, as the baseline time over the current time.
+  `glue` is the time spent in the native code outside CP-SAT: `marshal` and
+  `solve_overhead`.
+  """
+  def compare(runs, baseline_path) do
+    baseline =
+      baseline_path
+      |> File.read!()
+      |> :erlang.binary_to_term()
+      |> Map.new(&{&1["name"], &1})
+
+    Enum.map(runs, fn run ->
+      case Map.get(baseline, run["name"]) do
+        nil ->
+          run
+
+        base ->
+          speedup =
+            ~w(resolve marshal solve_overhead total glue)
+            |> Map.new(fn phase -> {phase, ratio(phase_us(base, phase), phase_us(run, phase))} end)
+
+          Map.put(run, "speedup", speedup)
+      end
+    end)
+  end
+
+  defp phase_us(run, "glue"), do: run["phases_us"]["marshal"] + run["phases_us"]["solve_overhead"]
+  defp phase_us(run, phase), do: run["phases_us"][phase]
+
+  defp ratio(_base, 0), do: nil
+  defp ratio(base, current), do: Float.round(base / current, 3)
+
+  @doc """
+  Parse the common command line options.
+  """
+  def options(argv) do
+    {opts, _args} =
+      OptionParser.parse!(argv,
+        strict: [
+          output: :string,
+          iterations: :integer,
+          only: :string,
+          save: :string,
+          baseline: :string
+        ]
+      )
+
+    %{
+      output: opts[:output],
+      iterations: Keyword.get(opts, :iterations, 5),
+      only: opts[:only] && String.split(opts[:only], ","),
+      save: opts[:save],
+      baseline: opts[:baseline]
+    }
+  end
+
+  @doc """
+  The metadata of the benchmark environment.
+  """
+  def environment do
+    %{
+      "exhort" => Application.spec(:exhort, :vsn) |> to_string(),
+      "otp_release" => :erlang.system_info(:otp_release) |> to_string(),
+      "elixir" => System.version(),
+      "schedulers" => :erlang.system_info(:schedulers_online),
+      "timestamp" => DateTime.utc_now() |> DateTime.to_iso8601()
+    }
+  end
+
+  # A small JSON encoder, so the benchmarks need no dependency.
+  def to_json(nil), do: "null"
+  def to_json(true), do: "true"
+  def to_json(false), do: "false"
+  def to_json(value) when is_integer(value), do: Integer.to_string(value)
+  def to_json(value) when is_float(value), do: Float.to_string(value)
+  def to_json(value) when is_atom(value), do: to_json(Atom.to_string(value))
+
+  def to_json(value) when is_binary(value) do
+    escaped =
+      value
+      |> String.replace("\\", "\\\\")
+      |> String.replace("\"", "\\\"")
+      |> String.replace("\n", "\\n")
+
+    "\"" <> escaped <> "\""
+  end
+
+  def to_json(value) when is_list(value) do
+    "[" <> Enum.map_join(value, ",", &to_json/1) <> "]"
+  end
+
+  def to_json(value) when is_map(value) do
+    entries =
+      value
+      |> Enum.sort_by(fn {key, _} -> to_string(key) end)
+      |> Enum.map_join(",", fn {key, value} -> to_json(to_string(key)) <> ":" <> to_json(value) end)
+
+    "{" <> entries <> "}"
+  end
+end
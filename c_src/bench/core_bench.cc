@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "ortools/sat/cp_model.h"
+#include "../core/expression.h"
+#include "../core/model_assembly.h"
+#include "../core/solution.h"
+
+using operations_research::Domain;
+using operations_research::sat::CpModelBuilder;
+using operations_research::sat::CpSolverResponse;
+
+using namespace std;
+
+// Microbenchmarks of the core layer, run without a BEAM:
+//
+//     make microbench && priv/bench/core_bench
+
+static void new_int_vars(CpModelBuilder *builder, int64_t size, vector<int32_t> *indexes)
+{
+  for (int64_t i = 0; i < size; ++i)
+  {
+    indexes->push_back(builder->NewIntVar(Domain(0, 100)).index());
+  }
+}
+
+static void BM_CanonicalizeLinearExpr(benchmark::State &state)
+{
+  int64_t size = state.range(0);
+
+  PackedLinearExpr expr;
+  expr.constant = 0;
+  for (int64_t i = 0; i < size; ++i)
+  {
+    // Every variable appears twice, in reverse order the second time.
+    expr.vars.push_back(i % (size / 2 + 1));
+    expr.coeffs.push_back(i + 1);
+  }
+
+  for (auto _ : state)
+  {
+    PackedLinearExpr copy = expr;
+    canonicalize_linear_expr(&copy);
+    benchmark::DoNotOptimize(copy.vars.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_CanonicalizeLinearExpr)->RangeMultiplier(10)->Range(10, 1000000);
+
+static void BM_AddLinearPacked(benchmark::State &state)
+{
+  int64_t size = state.range(0);
+
+  CpModelBuilder builder;
+  vector<int32_t> vars;
+  new_int_vars(&builder, size, &vars);
+  vector<int64_t> coeffs(size, 3);
+
+  for (auto _ : state)
+  {
+    add_linear_packed(&builder, vars.data(), coeffs.data(), size, 0, 100 * size);
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_AddLinearPacked)->RangeMultiplier(10)->Range(10, 100000);
+
+static void BM_AssembleModel(benchmark::State &state)
+{
+  int64_t size = state.range(0);
+
+  for (auto _ : state)
+  {
+    CpModelBuilder builder;
+    vector<int32_t> vars;
+    new_int_vars(&builder, size, &vars);
+    vector<int64_t> coeffs(2, 1);
+    for (int64_t i = 0; i + 1 < size; ++i)
+    {
+      add_linear_packed(&builder, &vars[i], coeffs.data(), 2, 0, 150);
+    }
+    benchmark::DoNotOptimize(builder.Build().ByteSizeLong());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_AssembleModel)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+static void solved_response(int64_t size, CpSolverResponse *response, vector<int> *vars)
+{
+  for (int64_t i = 0; i < size; ++i)
+  {
+    response->add_solution(i % 2);
+    vars->push_back(size - 1 - i);
+  }
+}
+
+static void BM_ExtractInt64Row(benchmark::State &state)
+{
+  int64_t size = state.range(0);
+  CpSolverResponse response;
+  vector<int> vars;
+  solved_response(size, &response, &vars);
+  vector<int64_t> row(size);
+
+  for (auto _ : state)
+  {
+    extract_int64_row(response, vars.data(), size, row.data());
+    benchmark::DoNotOptimize(row.data());
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(int64_t));
+}
+BENCHMARK(BM_ExtractInt64Row)->RangeMultiplier(10)->Range(10, 1000000);
+
+static void BM_ExtractBitsetRow(benchmark::State &state)
+{
+  int64_t size = state.range(0);
+  CpSolverResponse response;
+  vector<int> vars;
+  solved_response(size, &response, &vars);
+  vector<unsigned char> row(bitset_row_bytes(size));
+
+  for (auto _ : state)
+  {
+    extract_bitset_row(response, vars.data(), size, row.data());
+    benchmark::DoNotOptimize(row.data());
+  }
+  state.SetBytesProcessed(state.iterations() * row.size());
+}
+BENCHMARK(BM_ExtractBitsetRow)->RangeMultiplier(10)->Range(10, 1000000);
+
+BENCHMARK_MAIN();
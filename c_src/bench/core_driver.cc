@@ -0,0 +1,157 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "ortools/sat/cp_model.h"
+#include "../core/expression.h"
+#include "../core/model_assembly.h"
+#include "../core/solution.h"
+
+using operations_research::Domain;
+using operations_research::sat::CpModelBuilder;
+using operations_research::sat::CpModelProto;
+using operations_research::sat::CpSolverResponse;
+using operations_research::sat::IntVar;
+
+using namespace std;
+
+// Checks the core layer, then runs each operation in a loop sized for
+// profiling without a BEAM:
+//
+//     make core_driver && perf record priv/bench/core_driver 100000
+
+static int failures = 0;
+
+static void check(bool ok, const char *condition, int line)
+{
+  if (!ok)
+  {
+    fprintf(stderr, "%s:%d: failed %s\n", __FILE__, line, condition);
+    ++failures;
+  }
+}
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static void check_canonicalize()
+{
+  PackedLinearExpr expr{{3, 1, 3, 2, 1}, {2, 5, 4, 0, -5}, 7};
+  canonicalize_linear_expr(&expr);
+
+  CHECK(expr.vars == vector<int>({3}));
+  CHECK(expr.coeffs == vector<int64_t>({6}));
+  CHECK(expr.constant == 7);
+}
+
+static void check_assembly()
+{
+  CpModelBuilder builder;
+  IntVar x = builder.NewIntVar(Domain(0, 10));
+  IntVar y = builder.NewIntVar(Domain(0, 10));
+  builder.NewBoolVar();
+
+  int32_t vars[] = {x.index(), y.index()};
+  int64_t coeffs[] = {1, 3000000000};
+  add_linear_packed(&builder, vars, coeffs, 2, 0, 5);
+
+  const CpModelProto &model = builder.Build();
+  CHECK(model.constraints_size() == 1);
+  CHECK(model.constraints(0).linear().coeffs(1) == 3000000000);
+  CHECK(!is_boolean_var(model, 0));
+  CHECK(is_boolean_var(model, 2));
+
+  CpModelProto copy = model;
+  set_objective(&copy, x + x + y, true);
+  CHECK(copy.objective().vars_size() == 2);
+  CHECK(copy.objective().coeffs(0) == -2);
+  CHECK(copy.objective().scaling_factor() == -1);
+}
+
+static void check_solution()
+{
+  CpSolverResponse response;
+  for (int i = 0; i < 10; ++i)
+  {
+    response.add_solution(i % 3 == 0);
+  }
+  int vars[] = {0, 1, 3, 9};
+
+  int64_t row[4];
+  extract_int64_row(response, vars, 4, row);
+  CHECK(row[0] == 1 && row[1] == 0 && row[2] == 1 && row[3] == 1);
+
+  unsigned char bits[1];
+  CHECK(bitset_row_bytes(4) == 1);
+  extract_bitset_row(response, vars, 4, bits);
+  CHECK(bits[0] == 0x0d);
+}
+
+template <typename F>
+static void profile(const char *name, long iterations, F f)
+{
+  auto start = chrono::steady_clock::now();
+  for (long i = 0; i < iterations; ++i)
+  {
+    f();
+  }
+  chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+  printf("%-24s %10ld iterations %12.3f us/iteration\n", name, iterations, elapsed.count() / iterations);
+}
+
+int main(int argc, char **argv)
+{
+  check_canonicalize();
+  check_assembly();
+  check_solution();
+
+  if (failures > 0)
+  {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+
+  long iterations = argc > 1 ? atol(argv[1]) : 0;
+  if (iterations <= 0)
+  {
+    printf("all checks passed\n");
+    return 0;
+  }
+
+  const int size = 1000;
+
+  PackedLinearExpr expr;
+  expr.constant = 0;
+  for (int i = 0; i < size; ++i)
+  {
+    expr.vars.push_back(size - 1 - i % (size / 2));
+    expr.coeffs.push_back(i);
+  }
+  profile("canonicalize", iterations, [&]()
+          { PackedLinearExpr copy = expr; canonicalize_linear_expr(&copy); });
+
+  CpModelBuilder builder;
+  vector<int32_t> vars;
+  for (int i = 0; i < size; ++i)
+  {
+    vars.push_back(builder.NewIntVar(Domain(0, 100)).index());
+  }
+  vector<int64_t> coeffs(size, 1);
+  profile("add_linear_packed", iterations / 10 + 1, [&]()
+          { add_linear_packed(&builder, vars.data(), coeffs.data(), size, 0, 100); });
+
+  CpSolverResponse response;
+  for (int i = 0; i < size; ++i)
+  {
+    response.add_solution(i % 2);
+  }
+  vector<int> indexes(vars.begin(), vars.end());
+  vector<int64_t> row(size);
+  vector<unsigned char> bits(bitset_row_bytes(size));
+  profile("extract_int64_row", iterations, [&]()
+          { extract_int64_row(response, indexes.data(), size, row.data()); });
+  profile("extract_bitset_row", iterations, [&]()
+          { extract_bitset_row(response, indexes.data(), size, bits.data()); });
+
+  return 0;
+}
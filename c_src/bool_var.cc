@@ -2,6 +2,8 @@
 #include "erl_nif.h"
 #include "ortools/sat/cp_model.h"
 #include "wrappers.h"
+#include "native_memory.h"
+#include "decode.h"
 
 extern "C"
 {
@@ -11,6 +13,7 @@ extern "C"
   {
     BoolVarWrapper *w = (BoolVarWrapper *)obj;
     delete w->p;
+    release_native_resource(BOOL_VAR_RESOURCE, sizeof(BoolVar));
   }
 
   static int init_types(ErlNifEnv *env)
@@ -31,6 +34,7 @@ extern "C"
       return enif_make_badarg(env);
 
     bool_var_wrapper->p = new BoolVar(from_bool_var);
+    count_native_resource(BOOL_VAR_RESOURCE, sizeof(BoolVar));
     ERL_NIF_TERM term = enif_make_resource(env, bool_var_wrapper);
     enif_release_resource(bool_var_wrapper);
 
@@ -41,7 +45,7 @@ extern "C"
   {
     BoolVarWrapper *var;
 
-    if (!get_bool_var(env, argv[0], &var))
+    if (!decode(env, argv[0], &var))
     {
       return enif_make_badarg(env);
     }
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <numeric>
+#include "ortools/sat/cp_model.h"
+#include "expression.h"
+
+using operations_research::sat::IntVar;
+
+using namespace std;
+
+PackedLinearExpr pack_linear_expr(const LinearExpr &expr)
+{
+  return PackedLinearExpr{expr.variables(), expr.coefficients(), expr.constant()};
+}
+
+void canonicalize_linear_expr(PackedLinearExpr *expr)
+{
+  size_t size = expr->vars.size();
+
+  vector<size_t> order(size);
+  iota(order.begin(), order.end(), 0);
+  stable_sort(order.begin(), order.end(), [expr](size_t a, size_t b)
+              { return expr->vars[a] < expr->vars[b]; });
+
+  vector<int> vars;
+  vector<int64_t> coeffs;
+  vars.reserve(size);
+  coeffs.reserve(size);
+
+  for (size_t i : order)
+  {
+    if (!vars.empty() && vars.back() == expr->vars[i])
+    {
+      coeffs.back() += expr->coeffs[i];
+    }
+    else
+    {
+      vars.push_back(expr->vars[i]);
+      coeffs.push_back(expr->coeffs[i]);
+    }
+
+    if (coeffs.back() == 0)
+    {
+      vars.pop_back();
+      coeffs.pop_back();
+    }
+  }
+
+  expr->vars.swap(vars);
+  expr->coeffs.swap(coeffs);
+}
+
+LinearExpr unpack_linear_expr(CpModelBuilder *builder, const PackedLinearExpr &expr)
+{
+  vector<IntVar> vars;
+  vars.reserve(expr.vars.size());
+  for (int var : expr.vars)
+  {
+    vars.push_back(builder->GetIntVarFromProtoIndex(var));
+  }
+
+  LinearExpr result = LinearExpr::WeightedSum(vars, expr.coeffs);
+  result += expr.constant;
+  return result;
+}
+
+LinearExpr canonical_linear_expr(CpModelBuilder *builder, const LinearExpr &expr)
+{
+  PackedLinearExpr packed = pack_linear_expr(expr);
+  canonicalize_linear_expr(&packed);
+  return unpack_linear_expr(builder, packed);
+}
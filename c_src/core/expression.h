@@ -0,0 +1,31 @@
+#ifndef __CORE_EXPRESSION_H__
+#define __CORE_EXPRESSION_H__
+
+#include <cstdint>
+#include <vector>
+#include "ortools/sat/cp_model.h"
+
+using operations_research::sat::CpModelBuilder;
+using operations_research::sat::LinearExpr;
+
+// A linear expression as parallel arrays of variable indexes and
+// coefficients, free of the `IntVar` handles that need a builder to create.
+typedef struct
+{
+  std::vector<int> vars;
+  std::vector<int64_t> coeffs;
+  int64_t constant;
+} PackedLinearExpr;
+
+PackedLinearExpr pack_linear_expr(const LinearExpr &expr);
+
+// Merge the terms of each variable, drop the zero terms and order the terms
+// by variable index.
+void canonicalize_linear_expr(PackedLinearExpr *expr);
+
+LinearExpr unpack_linear_expr(CpModelBuilder *builder, const PackedLinearExpr &expr);
+
+// The canonical form of `expr`, for the variables of `builder`.
+LinearExpr canonical_linear_expr(CpModelBuilder *builder, const LinearExpr &expr);
+
+#endif
@@ -0,0 +1,193 @@
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/cp_model_utils.h"
+#include "ortools/util/sorted_interval_list.h"
+#include "expression.h"
+#include "model_assembly.h"
+
+using operations_research::Domain;
+using operations_research::sat::ApplyToAllIntervalIndices;
+using operations_research::sat::ApplyToAllLiteralIndices;
+using operations_research::sat::ApplyToAllVariableIndices;
+using operations_research::sat::ConstraintProto;
+using operations_research::sat::CpObjectiveProto;
+
+using namespace std;
+
+void int_vars_from_indexes(CpModelBuilder *builder, const int32_t *indexes, size_t size, vector<IntVar> *vars)
+{
+  vars->reserve(vars->size() + size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    vars->push_back(builder->GetIntVarFromProtoIndex(indexes[i]));
+  }
+}
+
+void bool_vars_from_refs(CpModelBuilder *builder, const int32_t *refs, size_t size, vector<BoolVar> *vars)
+{
+  vars->reserve(vars->size() + size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    int32_t ref = refs[i];
+    vars->push_back(ref >= 0 ? builder->GetBoolVarFromProtoIndex(ref) : builder->GetBoolVarFromProtoIndex(-ref - 1).Not());
+  }
+}
+
+Constraint add_linear_packed(CpModelBuilder *builder, const int32_t *vars, const int64_t *coeffs, size_t size, int64_t lower, int64_t upper)
+{
+  vector<IntVar> int_vars;
+  int_vars_from_indexes(builder, vars, size, &int_vars);
+
+  return builder->AddLinearConstraint(LinearExpr::WeightedSum(int_vars, absl::Span<const int64_t>(coeffs, size)), Domain(lower, upper));
+}
+
+void add_cumulative_demands(ConstraintProto *cumulative, const int32_t *intervals, const int64_t *demands, size_t size)
+{
+  auto *proto = cumulative->mutable_cumulative();
+  proto->mutable_intervals()->Reserve(proto->intervals_size() + size);
+  proto->mutable_demands()->Reserve(proto->demands_size() + size);
+
+  for (size_t i = 0; i < size; ++i)
+  {
+    proto->add_intervals(intervals[i]);
+    proto->add_demands()->set_offset(demands[i]);
+  }
+}
+
+void add_cumulative_demand(ConstraintProto *cumulative, int32_t interval, const LinearExpr &demand)
+{
+  auto *proto = cumulative->mutable_cumulative();
+  proto->add_intervals(interval);
+
+  auto *expr = proto->add_demands();
+  for (size_t i = 0; i < demand.variables().size(); ++i)
+  {
+    expr->add_vars(demand.variables()[i]);
+    expr->add_coeffs(demand.coefficients()[i]);
+  }
+  expr->set_offset(demand.constant());
+}
+
+Constraint add_table_packed(CpModelBuilder *builder, const vector<IntVar> &vars, const int64_t *values, size_t size, bool negated)
+{
+  Constraint constraint = negated ? builder->AddForbiddenAssignments(vars) : builder->AddAllowedAssignments(vars);
+
+  auto *table = constraint.MutableProto()->mutable_table()->mutable_values();
+  table->Reserve(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    table->Add(values[i]);
+  }
+
+  return constraint;
+}
+
+// Both CircuitConstraintProto and RoutesConstraintProto.
+template <typename P>
+static void add_arcs(P *proto, const int32_t *arcs, size_t size)
+{
+  proto->mutable_tails()->Reserve(proto->tails_size() + size);
+  proto->mutable_heads()->Reserve(proto->heads_size() + size);
+  proto->mutable_literals()->Reserve(proto->literals_size() + size);
+
+  for (size_t i = 0; i < size; ++i)
+  {
+    proto->add_tails(arcs[3 * i]);
+    proto->add_heads(arcs[3 * i + 1]);
+    proto->add_literals(arcs[3 * i + 2]);
+  }
+}
+
+Constraint add_circuit_packed(CpModelBuilder *builder, const int32_t *arcs, size_t size, bool multiple)
+{
+  if (multiple)
+  {
+    Constraint constraint = builder->AddMultipleCircuitConstraint();
+    add_arcs(constraint.MutableProto()->mutable_routes(), arcs, size);
+    return constraint;
+  }
+
+  Constraint constraint = builder->AddCircuitConstraint();
+  add_arcs(constraint.MutableProto()->mutable_circuit(), arcs, size);
+  return constraint;
+}
+
+bool is_boolean_var(const CpModelProto &model, int index)
+{
+  const auto &domain = model.variables(index).domain();
+  return domain.size() > 0 && domain[0] >= 0 && domain[domain.size() - 1] <= 1;
+}
+
+ModelBlock start_model_block(const CpModelProto &model, CpModelProto *block_model)
+{
+  *block_model->mutable_variables() = model.variables();
+  for (int i = 0; i < model.constraints_size(); ++i)
+  {
+    block_model->add_constraints();
+  }
+
+  return ModelBlock{model.variables_size(), model.constraints_size()};
+}
+
+ModelBlock merge_model_block(CpModelProto *model, const CpModelProto &block_model, const ModelBlock &block)
+{
+  ModelBlock merged{model->variables_size(), model->constraints_size()};
+
+  auto variable = [&](int *index)
+  {
+    *index = remap_block_variable(*index, block, merged);
+  };
+
+  auto literal = [&](int *ref)
+  {
+    *ref = *ref >= 0 ? remap_block_variable(*ref, block, merged) : -remap_block_variable(-*ref - 1, block, merged) - 1;
+  };
+
+  auto interval = [&](int *index)
+  {
+    *index = remap_block_constraint(*index, block, merged);
+  };
+
+  for (int i = block.base_variables; i < block_model.variables_size(); ++i)
+  {
+    *model->add_variables() = block_model.variables(i);
+  }
+
+  for (int i = block.base_constraints; i < block_model.constraints_size(); ++i)
+  {
+    ConstraintProto *constraint = model->add_constraints();
+    *constraint = block_model.constraints(i);
+    ApplyToAllVariableIndices(variable, constraint);
+    ApplyToAllLiteralIndices(literal, constraint);
+    ApplyToAllIntervalIndices(interval, constraint);
+  }
+
+  return merged;
+}
+
+int remap_block_variable(int index, const ModelBlock &block, const ModelBlock &merged)
+{
+  return index < block.base_variables ? index : index - block.base_variables + merged.base_variables;
+}
+
+int remap_block_constraint(int index, const ModelBlock &block, const ModelBlock &merged)
+{
+  return index < block.base_constraints ? index : index - block.base_constraints + merged.base_constraints;
+}
+
+void set_objective(CpModelProto *model, const LinearExpr &expr, bool maximize)
+{
+  int64_t sign = maximize ? -1 : 1;
+
+  PackedLinearExpr packed = pack_linear_expr(expr);
+  canonicalize_linear_expr(&packed);
+
+  model->clear_objective();
+  CpObjectiveProto *proto = model->mutable_objective();
+  for (size_t i = 0; i < packed.vars.size(); ++i)
+  {
+    proto->add_vars(packed.vars[i]);
+    proto->add_coeffs(sign * packed.coeffs[i]);
+  }
+  proto->set_offset((double)(sign * packed.constant));
+  proto->set_scaling_factor((double)sign);
+}
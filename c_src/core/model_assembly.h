@@ -0,0 +1,79 @@
+#ifndef __CORE_MODEL_ASSEMBLY_H__
+#define __CORE_MODEL_ASSEMBLY_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ortools/sat/cp_model.h"
+
+using operations_research::sat::BoolVar;
+using operations_research::sat::Constraint;
+using operations_research::sat::ConstraintProto;
+using operations_research::sat::CpModelBuilder;
+using operations_research::sat::CpModelProto;
+using operations_research::sat::IntVar;
+using operations_research::sat::LinearExpr;
+
+// The variables of `builder` at `indexes`.
+void int_vars_from_indexes(CpModelBuilder *builder, const int32_t *indexes, size_t size, std::vector<IntVar> *vars);
+
+// The literals of `builder` for `refs`, where a negative ref `-i - 1` is the
+// negation of variable `i`.
+void bool_vars_from_refs(CpModelBuilder *builder, const int32_t *refs, size_t size, std::vector<BoolVar> *vars);
+
+// Add `lower <= sum(coeffs[i] * vars[i]) <= upper` from packed arrays.
+Constraint add_linear_packed(CpModelBuilder *builder, const int32_t *vars, const int64_t *coeffs, size_t size, int64_t lower, int64_t upper);
+
+// Append the tasks of `intervals` with the fixed `demands` to a cumulative
+// constraint, where each interval is given by the index of its constraint.
+void add_cumulative_demands(ConstraintProto *cumulative, const int32_t *intervals, const int64_t *demands, size_t size);
+
+// Append the task of interval `interval` with the variable `demand` to a
+// cumulative constraint.
+void add_cumulative_demand(ConstraintProto *cumulative, int32_t interval, const LinearExpr &demand);
+
+// Add a table constraint on `vars` from the `size / vars.size()` tuples of
+// `values`, row-major: the allowed assignments of `vars`, or the forbidden
+// ones when `negated`.
+Constraint add_table_packed(CpModelBuilder *builder, const std::vector<IntVar> &vars, const int64_t *values, size_t size, bool negated);
+
+// Add a circuit constraint, or a multiple circuit constraint when `multiple`,
+// over the `size` arcs of `arcs`, packed as (tail, head, literal ref) triples.
+Constraint add_circuit_packed(CpModelBuilder *builder, const int32_t *arcs, size_t size, bool multiple);
+
+// Whether the domain of variable `index` of `model` is within [0, 1].
+bool is_boolean_var(const CpModelProto &model, int index);
+
+// The start of a block of a model: its first `base_variables` variables are
+// shared with the model it was started from, and its first `base_constraints`
+// constraints stand for the constraints of that model.
+struct ModelBlock
+{
+  int base_variables;
+  int base_constraints;
+};
+
+// Start `block` from `model`: copy the variables of `model` and add an empty
+// placeholder for each of its constraints, so that indexes below the base
+// refer to `model` in both.
+ModelBlock start_model_block(const CpModelProto &model, CpModelProto *block_model);
+
+// Append the variables and constraints added to `block_model` since `block`
+// was started to `model`, remapping the indexes of the variables, literals and
+// intervals they refer to. Returns the indexes in `model` of the first
+// appended variable and constraint. The objective, search strategies and hint
+// of `block_model` are not merged.
+ModelBlock merge_model_block(CpModelProto *model, const CpModelProto &block_model, const ModelBlock &block);
+
+// The index in the merged model of variable `index` of a block.
+int remap_block_variable(int index, const ModelBlock &block, const ModelBlock &merged);
+
+// The index in the merged model of constraint `index` of a block.
+int remap_block_constraint(int index, const ModelBlock &block, const ModelBlock &merged);
+
+// Replace the objective of `model` the way `CpModelBuilder` does: a
+// maximization is stored as the minimization of the negated expression. The
+// terms are canonicalized.
+void set_objective(CpModelProto *model, const LinearExpr &expr, bool maximize);
+
+#endif
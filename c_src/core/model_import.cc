@@ -0,0 +1,811 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "ortools/sat/cp_model.h"
+#include "ortools/util/sorted_interval_list.h"
+#include "model_assembly.h"
+#include "model_import.h"
+
+using operations_research::Domain;
+using operations_research::sat::BoolVar;
+using operations_research::sat::IntVar;
+using operations_research::sat::LinearExpr;
+
+using namespace std;
+
+namespace
+{
+  // Split the text into lines without copying it.
+  class LineReader
+  {
+  public:
+    LineReader(const char *data, size_t size) : p_(data), end_(data + size), line_(0) {}
+
+    bool Next(string_view *line)
+    {
+      if (p_ >= end_)
+      {
+        return false;
+      }
+
+      const char *start = p_;
+      const char *newline = (const char *)memchr(p_, '\n', end_ - p_);
+      const char *stop = newline != NULL ? newline : end_;
+      p_ = newline != NULL ? newline + 1 : end_;
+      if (stop > start && stop[-1] == '\r')
+      {
+        --stop;
+      }
+
+      *line = string_view(start, stop - start);
+      ++line_;
+      return true;
+    }
+
+    size_t Line() const { return line_; }
+
+  private:
+    const char *p_;
+    const char *end_;
+    size_t line_;
+  };
+
+  // Append the tokens of `line`, split at whitespace and, when `semicolons`
+  // is set, with each `;` as a token of its own.
+  void tokenize(string_view line, bool semicolons, vector<string_view> *tokens)
+  {
+    size_t i = 0;
+    while (i < line.size())
+    {
+      char c = line[i];
+      if (c == ' ' || c == '\t')
+      {
+        ++i;
+      }
+      else if (semicolons && c == ';')
+      {
+        tokens->push_back(line.substr(i, 1));
+        ++i;
+      }
+      else
+      {
+        size_t start = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t' && !(semicolons && line[i] == ';'))
+        {
+          ++i;
+        }
+        tokens->push_back(line.substr(start, i - start));
+      }
+    }
+  }
+
+  bool is_number(string_view token)
+  {
+    size_t i = !token.empty() && (token[0] == '+' || token[0] == '-') ? 1 : 0;
+    return i < token.size() && token[i] >= '0' && token[i] <= '9';
+  }
+
+  bool parse_int64(string_view token, int64_t *value)
+  {
+    if (!token.empty() && token[0] == '+')
+    {
+      token.remove_prefix(1);
+    }
+
+    const char *end = token.data() + token.size();
+    from_chars_result result = from_chars(token.data(), end, *value);
+    return !token.empty() && result.ec == errc() && result.ptr == end;
+  }
+
+  bool parse_double(string_view token, double *value)
+  {
+    char buffer[64];
+    if (token.empty() || token.size() >= sizeof(buffer))
+    {
+      return false;
+    }
+
+    memcpy(buffer, token.data(), token.size());
+    buffer[token.size()] = '\0';
+
+    char *end;
+    *value = strtod(buffer, &end);
+    return end == buffer + token.size();
+  }
+
+  // An integral value exactly representable as a double.
+  bool to_int64(double value, int64_t *out)
+  {
+    if (!(fabs(value) <= 9007199254740992.0) || value != floor(value))
+    {
+      return false;
+    }
+
+    *out = (int64_t)value;
+    return true;
+  }
+
+  bool fail(ImportError *error, size_t line, string message)
+  {
+    error->line = line;
+    error->message = move(message);
+    return false;
+  }
+
+  // The terms of a linear expression over model indexes.
+  struct LinearTerms
+  {
+    vector<int32_t> vars;
+    vector<int64_t> coeffs;
+    int64_t constant = 0;
+
+    void Clear()
+    {
+      vars.clear();
+      coeffs.clear();
+      constant = 0;
+    }
+  };
+
+  LinearExpr to_linear_expr(CpModelBuilder *builder, const LinearTerms &terms)
+  {
+    vector<IntVar> vars;
+    int_vars_from_indexes(builder, terms.vars.data(), terms.vars.size(), &vars);
+    return LinearExpr::WeightedSum(vars, terms.coeffs) + terms.constant;
+  }
+
+  class OpbReader
+  {
+  public:
+    OpbReader(CpModelBuilder *builder, vector<string> *names, ImportError *error)
+        : builder_(builder), names_(names), error_(error) {}
+
+    bool Read(const char *data, size_t size)
+    {
+      LineReader reader(data, size);
+      string_view line;
+      vector<string_view> tokens;
+      size_t statement_line = 1;
+
+      while (reader.Next(&line))
+      {
+        if (!line.empty() && line[0] == '*')
+        {
+          continue;
+        }
+
+        if (tokens.empty())
+        {
+          statement_line = reader.Line();
+        }
+        tokenize(line, true, &tokens);
+
+        // The tokens point into `data`, so a statement may span lines.
+        size_t start = 0;
+        for (size_t i = 0; i < tokens.size(); ++i)
+        {
+          if (tokens[i] == ";")
+          {
+            if (!Statement(&tokens[start], i - start, statement_line))
+            {
+              return false;
+            }
+            start = i + 1;
+            statement_line = reader.Line();
+          }
+        }
+        tokens.erase(tokens.begin(), tokens.begin() + start);
+      }
+
+      if (!tokens.empty())
+      {
+        return fail(error_, statement_line, "statement not terminated by ';'");
+      }
+
+      return true;
+    }
+
+  private:
+    bool Statement(const string_view *tokens, size_t n, size_t line)
+    {
+      if (n == 0)
+      {
+        return true;
+      }
+
+      if (tokens[0] == "min:" || tokens[0] == "max:")
+      {
+        if (!Terms(tokens + 1, n - 1, line))
+        {
+          return false;
+        }
+
+        LinearExpr objective = to_linear_expr(builder_, terms_);
+        if (tokens[0] == "max:")
+        {
+          builder_->Maximize(objective);
+        }
+        else
+        {
+          builder_->Minimize(objective);
+        }
+        return true;
+      }
+
+      size_t op = 0;
+      while (op < n && tokens[op] != ">=" && tokens[op] != "<=" && tokens[op] != "=")
+      {
+        ++op;
+      }
+
+      if (op + 2 != n)
+      {
+        return fail(error_, line, "expected `terms >= | <= | = rhs ;`");
+      }
+
+      int64_t rhs;
+      if (!parse_int64(tokens[op + 1], &rhs))
+      {
+        return fail(error_, line, "invalid right-hand side");
+      }
+
+      if (!Terms(tokens, op, line))
+      {
+        return false;
+      }
+
+      int64_t bound;
+      if (__builtin_sub_overflow(rhs, terms_.constant, &bound))
+      {
+        return fail(error_, line, "right-hand side overflows");
+      }
+
+      int64_t lower = tokens[op] == "<=" ? numeric_limits<int64_t>::min() : bound;
+      int64_t upper = tokens[op] == ">=" ? numeric_limits<int64_t>::max() : bound;
+      add_linear_packed(builder_, terms_.vars.data(), terms_.coeffs.data(), terms_.vars.size(), lower, upper);
+      return true;
+    }
+
+    // Read `coefficient literal` terms, where the coefficient defaults to 1
+    // and `~x` stands for `1 - x`.
+    bool Terms(const string_view *tokens, size_t n, size_t line)
+    {
+      terms_.Clear();
+
+      size_t i = 0;
+      while (i < n)
+      {
+        int64_t coeff = 1;
+        if (is_number(tokens[i]))
+        {
+          if (!parse_int64(tokens[i], &coeff) || coeff == numeric_limits<int64_t>::min())
+          {
+            return fail(error_, line, "invalid coefficient");
+          }
+          ++i;
+        }
+
+        if (i >= n || is_number(tokens[i]))
+        {
+          return fail(error_, line, "expected a literal");
+        }
+
+        if (i + 1 < n && !is_number(tokens[i + 1]))
+        {
+          return fail(error_, line, "non-linear terms are not supported");
+        }
+
+        string_view literal = tokens[i++];
+        bool negated = literal[0] == '~';
+        if (negated)
+        {
+          literal.remove_prefix(1);
+          if (literal.empty())
+          {
+            return fail(error_, line, "expected a literal");
+          }
+
+          if (__builtin_add_overflow(terms_.constant, coeff, &terms_.constant))
+          {
+            return fail(error_, line, "coefficients overflow");
+          }
+          coeff = -coeff;
+        }
+
+        terms_.vars.push_back(Var(literal));
+        terms_.coeffs.push_back(coeff);
+      }
+
+      return true;
+    }
+
+    int Var(string_view name)
+    {
+      auto it = indexes_.find(name);
+      if (it != indexes_.end())
+      {
+        return it->second;
+      }
+
+      BoolVar var = builder_->NewBoolVar();
+      indexes_.emplace(name, var.index());
+      names_->emplace_back(name);
+      return var.index();
+    }
+
+    CpModelBuilder *builder_;
+    vector<string> *names_;
+    ImportError *error_;
+    unordered_map<string_view, int> indexes_;
+    LinearTerms terms_;
+  };
+
+  typedef enum
+  {
+    MPS_NONE,
+    MPS_OBJSENSE,
+    MPS_ROWS,
+    MPS_COLUMNS,
+    MPS_RHS,
+    MPS_RANGES,
+    MPS_BOUNDS,
+    MPS_END
+  } MpsSection;
+
+  struct MpsRow
+  {
+    char type;
+    int64_t rhs = 0;
+    int64_t range = 0;
+    bool has_range = false;
+    vector<int32_t> vars;
+    vector<int64_t> coeffs;
+  };
+
+  struct MpsColumn
+  {
+    int64_t lower = 0;
+    int64_t upper = MPS_INFINITY;
+    bool integer = false;
+    size_t line = 0;
+  };
+
+  class MpsReader
+  {
+  public:
+    MpsReader(CpModelBuilder *builder, vector<string> *names, ImportError *error)
+        : builder_(builder), names_(names), error_(error) {}
+
+    bool Read(const char *data, size_t size)
+    {
+      if (builder_->Proto().variables_size() != 0)
+      {
+        return fail(error_, 0, "the builder is not empty");
+      }
+
+      LineReader reader(data, size);
+      string_view line;
+      vector<string_view> tokens;
+      MpsSection section = MPS_NONE;
+
+      while (section != MPS_END && reader.Next(&line))
+      {
+        line_ = reader.Line();
+        if (line.empty() || line[0] == '*')
+        {
+          continue;
+        }
+
+        tokens.clear();
+        tokenize(line, false, &tokens);
+        if (tokens.empty())
+        {
+          continue;
+        }
+
+        if (line[0] != ' ' && line[0] != '\t' && Section(tokens, &section))
+        {
+          continue;
+        }
+
+        if (!Data(section, tokens))
+        {
+          return false;
+        }
+      }
+
+      return Finish();
+    }
+
+  private:
+    // Switch to the section started by `tokens`, when they start one.
+    bool Section(const vector<string_view> &tokens, MpsSection *section)
+    {
+      const string_view &name = tokens[0];
+      if (name == "NAME")
+      {
+        *section = MPS_NONE;
+      }
+      else if (name == "OBJSENSE")
+      {
+        *section = MPS_OBJSENSE;
+        if (tokens.size() > 1)
+        {
+          Sense(tokens[1]);
+        }
+      }
+      else if (name == "ROWS")
+      {
+        *section = MPS_ROWS;
+      }
+      else if (name == "COLUMNS")
+      {
+        *section = MPS_COLUMNS;
+      }
+      else if (name == "RHS")
+      {
+        *section = MPS_RHS;
+      }
+      else if (name == "RANGES")
+      {
+        *section = MPS_RANGES;
+      }
+      else if (name == "BOUNDS")
+      {
+        *section = MPS_BOUNDS;
+      }
+      else if (name == "ENDATA")
+      {
+        *section = MPS_END;
+      }
+      else
+      {
+        return false;
+      }
+
+      return true;
+    }
+
+    void Sense(string_view sense)
+    {
+      maximize_ = sense == "MAX" || sense == "MAXIMIZE";
+    }
+
+    bool Data(MpsSection section, const vector<string_view> &tokens)
+    {
+      switch (section)
+      {
+      case MPS_OBJSENSE:
+        Sense(tokens[0]);
+        return true;
+      case MPS_ROWS:
+        return Row(tokens);
+      case MPS_COLUMNS:
+        return Column(tokens);
+      case MPS_RHS:
+      case MPS_RANGES:
+        return Rhs(tokens, section == MPS_RANGES);
+      case MPS_BOUNDS:
+        return Bound(tokens);
+      default:
+        return fail(error_, line_, "unsupported section or data outside a section");
+      }
+    }
+
+    bool Row(const vector<string_view> &tokens)
+    {
+      if (tokens.size() != 2 || tokens[0].size() != 1 || strchr("NLGE", tokens[0][0]) == NULL)
+      {
+        return fail(error_, line_, "expected `N | L | G | E row`");
+      }
+
+      int index = rows_.size();
+      if (!row_indexes_.emplace(tokens[1], index).second)
+      {
+        return fail(error_, line_, "duplicate row");
+      }
+
+      rows_.emplace_back();
+      rows_.back().type = tokens[0][0];
+      if (tokens[0][0] == 'N' && objective_ < 0)
+      {
+        objective_ = index;
+      }
+      return true;
+    }
+
+    bool Column(const vector<string_view> &tokens)
+    {
+      if (tokens.size() >= 3 && tokens[1] == "'MARKER'")
+      {
+        integer_ = tokens[2] == "'INTORG'";
+        return true;
+      }
+
+      if (tokens.size() != 3 && tokens.size() != 5)
+      {
+        return fail(error_, line_, "expected `column row value [row value]`");
+      }
+
+      if (column_ < 0 || tokens[0] != column_name_)
+      {
+        auto inserted = column_indexes_.emplace(tokens[0], columns_.size());
+        if (!inserted.second)
+        {
+          // The entries of a column are contiguous, so the column is defined
+          // again.
+          return fail(error_, line_, "duplicate variable " + string(tokens[0]));
+        }
+
+        column_ = columns_.size();
+        column_name_ = tokens[0];
+        columns_.emplace_back();
+        columns_.back().integer = integer_;
+        columns_.back().line = line_;
+      }
+
+      for (size_t i = 1; i + 1 < tokens.size(); i += 2)
+      {
+        int row;
+        int64_t value;
+        if (!RowValue(tokens[i], tokens[i + 1], &row, &value))
+        {
+          return false;
+        }
+
+        if (row == objective_)
+        {
+          objective_terms_.vars.push_back(column_);
+          objective_terms_.coeffs.push_back(value);
+        }
+        else if (rows_[row].type != 'N')
+        {
+          rows_[row].vars.push_back(column_);
+          rows_[row].coeffs.push_back(value);
+        }
+      }
+
+      return true;
+    }
+
+    // The RHS and RANGES entries, whose set name may be left out.
+    bool Rhs(const vector<string_view> &tokens, bool ranges)
+    {
+      size_t first = tokens.size() % 2 == 1 ? 1 : 0;
+      if (tokens.size() < 2 || tokens.size() > 5)
+      {
+        return fail(error_, line_, "expected `[set] row value [row value]`");
+      }
+
+      for (size_t i = first; i + 1 < tokens.size(); i += 2)
+      {
+        int row;
+        int64_t value;
+        if (!RowValue(tokens[i], tokens[i + 1], &row, &value))
+        {
+          return false;
+        }
+
+        if (row == objective_ && !ranges)
+        {
+          // The objective's right-hand side is its negated constant.
+          objective_terms_.constant = -value;
+        }
+        else if (ranges)
+        {
+          rows_[row].range = value;
+          rows_[row].has_range = true;
+        }
+        else
+        {
+          rows_[row].rhs = value;
+        }
+      }
+
+      return true;
+    }
+
+    bool RowValue(string_view name, string_view token, int *row, int64_t *value)
+    {
+      auto it = row_indexes_.find(name);
+      if (it == row_indexes_.end())
+      {
+        return fail(error_, line_, "unknown row " + string(name));
+      }
+
+      double v;
+      if (!parse_double(token, &v) || !to_int64(v, value))
+      {
+        return fail(error_, line_, "non-integral value " + string(token));
+      }
+
+      *row = it->second;
+      return true;
+    }
+
+    bool Bound(const vector<string_view> &tokens)
+    {
+      string_view type = tokens[0];
+      bool valued = type == "UP" || type == "LO" || type == "FX" || type == "UI" || type == "LI";
+      bool unvalued = type == "FR" || type == "MI" || type == "PL" || type == "BV";
+      if (!valued && !unvalued)
+      {
+        return fail(error_, line_, "unsupported bound type " + string(type));
+      }
+
+      // The bound set name may be left out.
+      size_t arity = valued ? 3 : 2;
+      if (tokens.size() != arity && tokens.size() != arity + 1)
+      {
+        return fail(error_, line_, "expected `type [set] column" + string(valued ? " value`" : "`"));
+      }
+
+      size_t column = tokens.size() == arity ? 1 : 2;
+      auto it = column_indexes_.find(tokens[column]);
+      if (it == column_indexes_.end())
+      {
+        return fail(error_, line_, "unknown column " + string(tokens[column]));
+      }
+      MpsColumn &c = columns_[it->second];
+
+      double value = 0;
+      if (valued && (!parse_double(tokens[column + 1], &value) || isnan(value)))
+      {
+        return fail(error_, line_, "invalid bound " + string(tokens[column + 1]));
+      }
+
+      // The bounds of an integer variable round inwards, and are limited to
+      // +/- MPS_INFINITY like infinite ones.
+      value = clamp(value, (double)-MPS_INFINITY, (double)MPS_INFINITY);
+      int64_t lower = (int64_t)ceil(value);
+      int64_t upper = (int64_t)floor(value);
+
+      if (type == "UP" || type == "UI")
+      {
+        if (upper < 0 && c.lower == 0)
+        {
+          c.lower = -MPS_INFINITY;
+        }
+        c.upper = upper;
+      }
+      else if (type == "LO" || type == "LI")
+      {
+        c.lower = lower;
+      }
+      else if (type == "FX")
+      {
+        c.lower = lower;
+        c.upper = upper;
+      }
+      else if (type == "FR")
+      {
+        c.lower = -MPS_INFINITY;
+        c.upper = MPS_INFINITY;
+      }
+      else if (type == "MI")
+      {
+        c.lower = -MPS_INFINITY;
+      }
+      else if (type == "PL")
+      {
+        c.upper = MPS_INFINITY;
+      }
+      else
+      {
+        c.lower = 0;
+        c.upper = 1;
+      }
+
+      c.integer = c.integer || type == "UI" || type == "LI" || type == "BV";
+      return true;
+    }
+
+    bool Finish()
+    {
+      for (size_t i = 0; i < columns_.size(); ++i)
+      {
+        const MpsColumn &c = columns_[i];
+        if (!c.integer)
+        {
+          return fail(error_, c.line, "continuous columns are not supported");
+        }
+
+        if (c.lower > c.upper)
+        {
+          return fail(error_, c.line, "the bounds of the column are empty");
+        }
+
+        builder_->NewIntVar(Domain(c.lower, c.upper));
+      }
+
+      names_->resize(columns_.size());
+      for (const auto &column : column_indexes_)
+      {
+        (*names_)[column.second] = string(column.first);
+      }
+
+      for (MpsRow &row : rows_)
+      {
+        if (row.type == 'N')
+        {
+          continue;
+        }
+
+        int64_t lower = row.rhs;
+        int64_t upper = row.rhs;
+        int64_t range = row.range < 0 ? -row.range : row.range;
+        if (row.type == 'L')
+        {
+          lower = row.has_range ? row.rhs - range : numeric_limits<int64_t>::min();
+        }
+        else if (row.type == 'G')
+        {
+          upper = row.has_range ? row.rhs + range : numeric_limits<int64_t>::max();
+        }
+        else if (row.has_range)
+        {
+          lower = row.range < 0 ? row.rhs + row.range : row.rhs;
+          upper = row.range < 0 ? row.rhs : row.rhs + row.range;
+        }
+
+        add_linear_packed(builder_, row.vars.data(), row.coeffs.data(), row.vars.size(), lower, upper);
+
+        // Release each row once it is in the model.
+        vector<int32_t>().swap(row.vars);
+        vector<int64_t>().swap(row.coeffs);
+      }
+
+      if (objective_ >= 0)
+      {
+        LinearExpr objective = to_linear_expr(builder_, objective_terms_);
+        if (maximize_)
+        {
+          builder_->Maximize(objective);
+        }
+        else
+        {
+          builder_->Minimize(objective);
+        }
+      }
+
+      return true;
+    }
+
+    CpModelBuilder *builder_;
+    vector<string> *names_;
+    ImportError *error_;
+    size_t line_ = 0;
+    bool maximize_ = false;
+    bool integer_ = false;
+
+    vector<MpsRow> rows_;
+    unordered_map<string_view, int> row_indexes_;
+    int objective_ = -1;
+    LinearTerms objective_terms_;
+
+    vector<MpsColumn> columns_;
+    unordered_map<string_view, int> column_indexes_;
+    int column_ = -1;
+    string_view column_name_;
+  };
+}
+
+bool import_opb(const char *data, size_t size, CpModelBuilder *builder, vector<string> *names, ImportError *error)
+{
+  OpbReader reader(builder, names, error);
+  return reader.Read(data, size);
+}
+
+bool import_mps(const char *data, size_t size, CpModelBuilder *builder, vector<string> *names, ImportError *error)
+{
+  MpsReader reader(builder, names, error);
+  return reader.Read(data, size);
+}
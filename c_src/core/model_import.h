@@ -0,0 +1,39 @@
+#ifndef __CORE_MODEL_IMPORT_H__
+#define __CORE_MODEL_IMPORT_H__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "ortools/sat/cp_model.h"
+
+using operations_research::sat::CpModelBuilder;
+
+// Streaming readers of external instances into an empty `builder`.
+//
+// The instance is read from `data`, typically a mapped file, one line at a
+// time, without copying the text. Variables are added to `builder` in the
+// order they are first defined and `names` gets the name of each, by model
+// index.
+//
+// - OPB: the linear pseudo-Boolean format of the PB competitions, with
+//   `min:` or `max:` objectives, `>=`, `<=` and `=` constraints and `~x`
+//   negated literals. Non-linear (product) terms are rejected.
+// - MPS: the free MPS format, with N, L, G and E rows, RANGES, the usual
+//   BOUNDS types and integer markers. CP-SAT has integer variables only, so
+//   continuous columns and non-integral coefficients are rejected. Infinite
+//   bounds are limited to +/- MPS_INFINITY, CP-SAT's own default bound for
+//   imported MIP variables.
+
+#define MPS_INFINITY 10000000
+
+typedef struct
+{
+  size_t line;
+  std::string message;
+} ImportError;
+
+bool import_opb(const char *data, size_t size, CpModelBuilder *builder, std::vector<std::string> *names, ImportError *error);
+
+bool import_mps(const char *data, size_t size, CpModelBuilder *builder, std::vector<std::string> *names, ImportError *error);
+
+#endif
@@ -0,0 +1,28 @@
+#include <cstring>
+#include "ortools/sat/cp_model.h"
+#include "solution.h"
+
+size_t bitset_row_bytes(size_t size)
+{
+  return (size + 7) / 8;
+}
+
+void extract_int64_row(const CpSolverResponse &response, const int *vars, size_t size, int64_t *row)
+{
+  for (size_t i = 0; i < size; ++i)
+  {
+    row[i] = response.solution(vars[i]);
+  }
+}
+
+void extract_bitset_row(const CpSolverResponse &response, const int *vars, size_t size, unsigned char *row)
+{
+  memset(row, 0, bitset_row_bytes(size));
+  for (size_t i = 0; i < size; ++i)
+  {
+    if (response.solution(vars[i]))
+    {
+      row[i / 8] |= (unsigned char)(1 << (i % 8));
+    }
+  }
+}
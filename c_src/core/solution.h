@@ -0,0 +1,21 @@
+#ifndef __CORE_SOLUTION_H__
+#define __CORE_SOLUTION_H__
+
+#include <cstddef>
+#include <cstdint>
+#include "ortools/sat/cp_model.h"
+
+using operations_research::sat::CpSolverResponse;
+
+// The bytes of a row of `size` values packed one bit each.
+size_t bitset_row_bytes(size_t size);
+
+// Copy the values of the variables at `vars` in the solution of `response`
+// into `row`.
+void extract_int64_row(const CpSolverResponse &response, const int *vars, size_t size, int64_t *row);
+
+// Pack the values of the boolean variables at `vars` into `row`, least
+// significant bit first. `row` holds `bitset_row_bytes(size)` bytes.
+void extract_bitset_row(const CpSolverResponse &response, const int *vars, size_t size, unsigned char *row);
+
+#endif
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <new>
 #include <iostream>
 #include "erl_nif.h"
 #include "ortools/sat/cp_model.h"
@@ -8,15 +11,25 @@
 #include "int_var.h"
 #include "interval_var.h"
 #include "cp_solver_response.h"
+#include "log_stream.h"
+#include "native_memory.h"
+#include "probes.h"
+#include "solve_monitor.h"
+#include "solve_options.h"
 #include "utility.h"
+#include "worker_stats.h"
+#include "core/expression.h"
+#include "core/model_assembly.h"
 
 #include "ortools/sat/model.h"
 #include "ortools/sat/sat_parameters.pb.h"
+#include "decode.h"
 
 using operations_research::Domain;
 using operations_research::sat::BoolVar;
 using operations_research::sat::Constraint;
 using operations_research::sat::CpModelBuilder;
+using operations_research::sat::CpModelProto;
 using operations_research::sat::CpSolverResponse;
 using operations_research::sat::IntVar;
 using operations_research::sat::LinearExpr;
@@ -40,13 +53,16 @@ extern "C"
   static void free_cp_model_builder(ErlNifEnv *env, void *obj)
   {
     BuilderWrapper *w = (BuilderWrapper *)obj;
+    track_native_memory(BUILDER_MEMORY, &w->bytes, 0);
     delete w->p;
+    release_native_resource(BUILDER_RESOURCE, sizeof(CpModelBuilder));
   }
 
   static void free_constraint(ErlNifEnv *env, void *obj)
   {
     ConstraintWrapper *w = (ConstraintWrapper *)obj;
     delete w->p;
+    release_native_resource(CONSTRAINT_RESOURCE, sizeof(Constraint));
   }
 
   static int init_types(ErlNifEnv *env)
@@ -60,25 +76,272 @@ extern "C"
     return 0;
   }
 
+  int get_cp_model_builder(ErlNifEnv *env, ERL_NIF_TERM term, BuilderWrapper **obj)
+  {
+    return enif_get_resource(env, term, CP_MODEL_BUILDER_WRAPPER, (void **)obj);
+  }
+
+  // Builder ids start at 1, so that no builder is the parent of a builder
+  // that was not started from another.
+  static uint64_t next_builder_id()
+  {
+    static atomic<uint64_t> last_id(0);
+    return ++last_id;
+  }
+
+  ERL_NIF_TERM make_cp_model_builder(ErlNifEnv *env, CpModelBuilder *builder)
+  {
+    BuilderWrapper *builder_wrapper = (BuilderWrapper *)enif_alloc_resource(CP_MODEL_BUILDER_WRAPPER, sizeof(BuilderWrapper));
+    if (builder_wrapper == NULL)
+    {
+      delete builder;
+      return enif_make_badarg(env);
+    }
+
+    builder_wrapper->p = builder;
+    count_native_resource(BUILDER_RESOURCE, sizeof(CpModelBuilder));
+    new (&builder_wrapper->bytes) atomic<size_t>(0);
+    builder_wrapper->id = next_builder_id();
+    builder_wrapper->parent = 0;
+    builder_wrapper->base_variables = 0;
+    builder_wrapper->base_constraints = 0;
+    new (&builder_wrapper->merged) atomic<bool>(false);
+    ERL_NIF_TERM term = enif_make_resource(env, builder_wrapper);
+    enif_release_resource(builder_wrapper);
+    return term;
+  }
+
+  static ERL_NIF_TERM make_constraint(ErlNifEnv *env, const BuilderWrapper *builder_wrapper, const Constraint &constraint)
+  {
+    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
+    if (constraint_wrapper == NULL)
+      return enif_make_badarg(env);
+
+    constraint_wrapper->p = new Constraint(constraint);
+    constraint_wrapper->builder = builder_wrapper->id;
+    count_native_resource(CONSTRAINT_RESOURCE, sizeof(Constraint));
+
+    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
+    enif_release_resource(constraint_wrapper);
+
+    return term;
+  }
+
   ERL_NIF_TERM new_builder_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
+    return make_cp_model_builder(env, new CpModelBuilder());
+  }
+
+  // Start a builder whose variables begin with those of `builder`, so that
+  // variables of `builder` may be used in its constraints. It may be filled in
+  // by another process while `builder` is not modified, and is merged back
+  // with `merge_builders_nif`.
+  ERL_NIF_TERM new_sub_builder_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *parent_wrapper;
+
+    if (!decode(env, argv[0], &parent_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
     BuilderWrapper *builder_wrapper = (BuilderWrapper *)enif_alloc_resource(CP_MODEL_BUILDER_WRAPPER, sizeof(BuilderWrapper));
     if (builder_wrapper == NULL)
       return enif_make_badarg(env);
 
     builder_wrapper->p = new CpModelBuilder();
+    count_native_resource(BUILDER_RESOURCE, sizeof(CpModelBuilder));
+    new (&builder_wrapper->bytes) atomic<size_t>(0);
+    builder_wrapper->id = next_builder_id();
+    builder_wrapper->parent = parent_wrapper->id;
+
+    ModelBlock block = start_model_block(parent_wrapper->p->Proto(), builder_wrapper->p->MutableProto());
+    builder_wrapper->base_variables = block.base_variables;
+    builder_wrapper->base_constraints = block.base_constraints;
+    new (&builder_wrapper->merged) atomic<bool>(false);
+
     ERL_NIF_TERM term = enif_make_resource(env, builder_wrapper);
     enif_release_resource(builder_wrapper);
 
     return term;
   }
 
+  typedef enum
+  {
+    BLOCK_INT_VAR,
+    BLOCK_BOOL_VAR,
+    BLOCK_INTERVAL_VAR
+  } BlockVarKind;
+
+  typedef struct
+  {
+    BlockVarKind kind;
+    int index;
+  } BlockVar;
+
+  static int get_block_vars(ErlNifEnv *env, ERL_NIF_TERM term, vector<BlockVar> *vars)
+  {
+    unsigned int length;
+    if (!enif_get_list_length(env, term, &length))
+    {
+      return 0;
+    }
+
+    vars->reserve(length);
+
+    ERL_NIF_TERM head;
+    ERL_NIF_TERM tail;
+    ERL_NIF_TERM current = term;
+    while (enif_get_list_cell(env, current, &head, &tail))
+    {
+      IntVarWrapper *int_var;
+      BoolVarWrapper *bool_var;
+      IntervalVarWrapper *interval_var;
+
+      if (decode(env, head, &int_var))
+      {
+        vars->push_back(BlockVar{BLOCK_INT_VAR, int_var->p->index()});
+      }
+      else if (decode(env, head, &bool_var))
+      {
+        vars->push_back(BlockVar{BLOCK_BOOL_VAR, bool_var->p->index()});
+      }
+      else if (decode(env, head, &interval_var))
+      {
+        vars->push_back(BlockVar{BLOCK_INTERVAL_VAR, interval_var->p->index()});
+      }
+      else
+      {
+        return 0;
+      }
+
+      current = tail;
+    }
+
+    return 1;
+  }
+
+  static ERL_NIF_TERM make_block_var(ErlNifEnv *env, CpModelBuilder *builder, const BlockVar &var, const ModelBlock &block, const ModelBlock &merged)
+  {
+    switch (var.kind)
+    {
+    case BLOCK_INT_VAR:
+    {
+      IntVar v = builder->GetIntVarFromProtoIndex(remap_block_variable(var.index, block, merged));
+      return make_int_var(env, v);
+    }
+    case BLOCK_BOOL_VAR:
+    {
+      int index = var.index >= 0 ? var.index : -var.index - 1;
+      BoolVar v = builder->GetBoolVarFromProtoIndex(remap_block_variable(index, block, merged));
+      if (var.index < 0)
+      {
+        v = v.Not();
+      }
+      return make_bool_var(env, v);
+    }
+    default:
+    {
+      IntervalVar v = builder->GetIntervalVarFromProtoIndex(remap_block_constraint(var.index, block, merged));
+      return make_interval_var(env, v);
+    }
+    }
+  }
+
+  // Merge the blocks `[{sub_builder, vars}]` into `builder`, in order. Each
+  // sub builder must have been started from `builder` with
+  // `new_sub_builder_nif` and is merged once; its objective and decision
+  // strategies are not merged. Returns, for each block, its `vars` as
+  // variables of `builder`.
+  ERL_NIF_TERM merge_builders_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    unsigned int length;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!enif_get_list_length(env, argv[1], &length))
+    {
+      return enif_make_badarg(env);
+    }
+
+    // Check every block before merging any of them.
+    vector<BuilderWrapper *> blocks;
+    vector<vector<BlockVar>> block_vars(length);
+    blocks.reserve(length);
+
+    const CpModelProto &proto = builder_wrapper->p->Proto();
+    ERL_NIF_TERM head;
+    ERL_NIF_TERM tail;
+    ERL_NIF_TERM current = argv[1];
+    while (enif_get_list_cell(env, current, &head, &tail))
+    {
+      const ERL_NIF_TERM *elements;
+      int arity;
+      BuilderWrapper *block_wrapper;
+
+      if (!enif_get_tuple(env, head, &arity, &elements) || arity != 2 ||
+          !decode(env, elements[0], &block_wrapper) ||
+          block_wrapper->parent != builder_wrapper->id ||
+          block_wrapper->merged ||
+          find(blocks.begin(), blocks.end(), block_wrapper) != blocks.end() ||
+          block_wrapper->base_variables > proto.variables_size() ||
+          block_wrapper->base_constraints > proto.constraints_size() ||
+          !get_block_vars(env, elements[1], &block_vars[blocks.size()]))
+      {
+        return enif_make_badarg(env);
+      }
+
+      blocks.push_back(block_wrapper);
+
+      current = tail;
+    }
+
+    // A block merged concurrently by another call since it was checked is
+    // left to that call.
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+      if (blocks[i]->merged.exchange(true))
+      {
+        for (size_t j = 0; j < i; ++j)
+        {
+          blocks[j]->merged = false;
+        }
+
+        return enif_make_badarg(env);
+      }
+    }
+
+    vector<ERL_NIF_TERM> results;
+    results.reserve(length);
+
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+      ModelBlock block{blocks[i]->base_variables, blocks[i]->base_constraints};
+      ModelBlock merged = merge_model_block(builder_wrapper->p->MutableProto(), blocks[i]->p->Proto(), block);
+
+      vector<ERL_NIF_TERM> vars;
+      vars.reserve(block_vars[i].size());
+      for (const BlockVar &var : block_vars[i])
+      {
+        vars.push_back(make_block_var(env, builder_wrapper->p, var, block, merged));
+      }
+
+      results.push_back(enif_make_list_from_array(env, vars.data(), vars.size()));
+    }
+
+    return enif_make_list_from_array(env, results.data(), results.size());
+  }
+
   ERL_NIF_TERM new_bool_var_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
     ErlNifBinary name;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
@@ -93,14 +356,18 @@ extern "C"
   {
     BuilderWrapper *builder_wrapper;
     ErlNifBinary name;
-    int upper_bound, lower_bound;
+    int64_t upper_bound, lower_bound;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[1], &lower_bound) || !decode(env, argv[2], &upper_bound))
     {
       return enif_make_badarg(env);
     }
-    enif_get_int(env, argv[1], &lower_bound);
-    enif_get_int(env, argv[2], &upper_bound);
+
     enif_inspect_iolist_as_binary(env, argv[3], &name);
 
     Domain domain(lower_bound, upper_bound);
@@ -114,16 +381,19 @@ extern "C"
 
     BuilderWrapper *builder_wrapper;
     ErlNifBinary name;
-    int value;
+    int64_t value;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
     enif_inspect_iolist_as_binary(env, argv[1], &name);
 
-    enif_get_int(env, argv[2], &value);
+    if (!decode(env, argv[2], &value))
+    {
+      return enif_make_badarg(env);
+    }
 
     IntVar v = builder_wrapper->p->NewConstant(value).WithName((char *)name.data);
 
@@ -138,24 +408,24 @@ extern "C"
     LinearExprWrapper *var3;
     ErlNifBinary name;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
     enif_inspect_iolist_as_binary(env, argv[1], &name);
 
-    if (!get_linear_expression(env, argv[2], &var1))
+    if (!decode(env, argv[2], &var1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[3], &var2))
+    if (!decode(env, argv[3], &var2))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[4], &var3))
+    if (!decode(env, argv[4], &var3))
     {
       return enif_make_badarg(env);
     }
@@ -174,29 +444,29 @@ extern "C"
     BoolVarWrapper *var4;
     ErlNifBinary name;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
     enif_inspect_iolist_as_binary(env, argv[1], &name);
 
-    if (!get_linear_expression(env, argv[2], &var1))
+    if (!decode(env, argv[2], &var1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[3], &var2))
+    if (!decode(env, argv[3], &var2))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[4], &var3))
+    if (!decode(env, argv[4], &var3))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_bool_var(env, argv[5], &var4))
+    if (!decode(env, argv[5], &var4))
     {
       return enif_make_badarg(env);
     }
@@ -206,74 +476,122 @@ extern "C"
     return make_interval_var(env, v);
   }
 
-  ERL_NIF_TERM add_abs_equal_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  // new_fixed_size_interval_var_nif(builder, name, start, size), where `size`
+  // is an integer, so only the start needs an expression.
+  ERL_NIF_TERM new_fixed_size_interval_var_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
-    IntVarWrapper *var1;
-    IntVarWrapper *var2;
+    LinearExprWrapper *start;
+    int64_t size;
+    ErlNifBinary name;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_int_var(env, argv[1], &var1))
+    enif_inspect_iolist_as_binary(env, argv[1], &name);
+
+    if (!decode(env, argv[2], &start))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_int_var(env, argv[2], &var2))
+    if (!decode(env, argv[3], &size) || size < 0)
     {
       return enif_make_badarg(env);
     }
 
-    Constraint constraint = builder_wrapper->p->AddAbsEquality(*var1->p, *var2->p);
+    IntervalVar v = builder_wrapper->p->NewFixedSizeIntervalVar(*start->p, size).WithName((char *)name.data);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
+    return make_interval_var(env, v);
+  }
+
+  ERL_NIF_TERM new_optional_fixed_size_interval_var_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    LinearExprWrapper *start;
+    int64_t size;
+    BoolVarWrapper *presence;
+    ErlNifBinary name;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
       return enif_make_badarg(env);
+    }
 
-    constraint_wrapper->p = new Constraint(constraint);
+    enif_inspect_iolist_as_binary(env, argv[1], &name);
 
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
+    if (!decode(env, argv[2], &start))
+    {
+      return enif_make_badarg(env);
+    }
 
-    return term;
+    if (!decode(env, argv[3], &size) || size < 0)
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!decode(env, argv[4], &presence))
+    {
+      return enif_make_badarg(env);
+    }
+
+    IntervalVar v = builder_wrapper->p->NewOptionalFixedSizeIntervalVar(*start->p, size, *presence->p).WithName((char *)name.data);
+
+    return make_interval_var(env, v);
   }
 
-  ERL_NIF_TERM add_abs_equal_constant_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  ERL_NIF_TERM add_abs_equal_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
-    long int1;
+    IntVarWrapper *var1;
     IntVarWrapper *var2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!enif_get_long(env, argv[1], &int1))
+    if (!decode(env, argv[1], &var1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_int_var(env, argv[2], &var2))
+    if (!decode(env, argv[2], &var2))
     {
       return enif_make_badarg(env);
     }
 
-    Constraint constraint = builder_wrapper->p->AddAbsEquality(int1, *var2->p);
+    Constraint constraint = builder_wrapper->p->AddAbsEquality(*var1->p, *var2->p);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
+    return make_constraint(env, builder_wrapper, constraint);
+  }
+
+  ERL_NIF_TERM add_abs_equal_constant_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    int64_t int1;
+    IntVarWrapper *var2;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
       return enif_make_badarg(env);
+    }
 
-    constraint_wrapper->p = new Constraint(constraint);
+    if (!decode(env, argv[1], &int1))
+    {
+      return enif_make_badarg(env);
+    }
 
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
+    if (!decode(env, argv[2], &var2))
+    {
+      return enif_make_badarg(env);
+    }
 
-    return term;
+    Constraint constraint = builder_wrapper->p->AddAbsEquality(int1, *var2->p);
+
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_equal_expr1_expr2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
@@ -282,68 +600,50 @@ extern "C"
     LinearExprWrapper *expr1;
     LinearExprWrapper *expr2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[1], &expr1))
+    if (!decode(env, argv[1], &expr1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[2], &expr2))
+    if (!decode(env, argv[2], &expr2))
     {
       return enif_make_badarg(env);
     }
 
     Constraint constraint = builder_wrapper->p->AddEquality(*expr1->p, *expr2->p);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
-
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
-
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_equal_expr1_constant2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
     LinearExprWrapper *expr1;
-    long constant2;
+    int64_t constant2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[1], &expr1))
+    if (!decode(env, argv[1], &expr1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!enif_get_int64(env, argv[2], &constant2))
+    if (!decode(env, argv[2], &constant2))
     {
       return enif_make_badarg(env);
     }
 
     Constraint constraint = builder_wrapper->p->AddEquality(*expr1->p, constant2);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
-
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
-
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_equal_int_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
@@ -352,52 +652,43 @@ extern "C"
     IntVarWrapper *var1;
     IntVarWrapper *var2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_int_var(env, argv[1], &var1))
+    if (!decode(env, argv[1], &var1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_int_var(env, argv[2], &var2))
+    if (!decode(env, argv[2], &var2))
     {
       return enif_make_badarg(env);
     }
 
     Constraint constraint = builder_wrapper->p->AddEquality(*var1->p, *var2->p);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
-
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
-
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_equal_int_var_plus_int_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
     IntVarWrapper *var1;
-    long constant2;
+    int64_t constant2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_int_var(env, argv[1], &var1))
+    if (!decode(env, argv[1], &var1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!enif_get_int64(env, argv[2], &constant2))
+    if (!decode(env, argv[2], &constant2))
     {
       return enif_make_badarg(env);
     }
@@ -406,16 +697,7 @@ extern "C"
     IntVar var2 = builder_wrapper->p->NewIntVar(d);
     Constraint constraint = builder_wrapper->p->AddEquality(*var1->p, LinearExpr::Sum({*var1->p, var2}));
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
-
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
-
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_not_equal_expr1_expr2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
@@ -424,33 +706,24 @@ extern "C"
     LinearExprWrapper *expr1;
     LinearExprWrapper *expr2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[1], &expr1))
+    if (!decode(env, argv[1], &expr1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[2], &expr2))
+    if (!decode(env, argv[2], &expr2))
     {
       return enif_make_badarg(env);
     }
 
     Constraint constraint = builder_wrapper->p->AddNotEqual(*expr1->p, *expr2->p);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
-
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
-
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_not_equal_bool_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
@@ -459,33 +732,24 @@ extern "C"
     BoolVarWrapper *var1;
     BoolVarWrapper *var2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_bool_var(env, argv[1], &var1))
+    if (!decode(env, argv[1], &var1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_bool_var(env, argv[2], &var2))
+    if (!decode(env, argv[2], &var2))
     {
       return enif_make_badarg(env);
     }
 
     Constraint constraint = builder_wrapper->p->AddNotEqual(*var1->p, *var2->p);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
-
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
-
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_less_than_expr1_expr2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
@@ -494,33 +758,24 @@ extern "C"
     LinearExprWrapper *expr1;
     LinearExprWrapper *expr2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[1], &expr1))
+    if (!decode(env, argv[1], &expr1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[2], &expr2))
+    if (!decode(env, argv[2], &expr2))
     {
       return enif_make_badarg(env);
     }
 
     Constraint constraint = builder_wrapper->p->AddLessThan(*expr1->p, *expr2->p);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
-
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
-
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_less_or_equal_expr1_expr2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
@@ -529,33 +784,24 @@ extern "C"
     LinearExprWrapper *expr1;
     LinearExprWrapper *expr2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[1], &expr1))
+    if (!decode(env, argv[1], &expr1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[2], &expr2))
+    if (!decode(env, argv[2], &expr2))
     {
       return enif_make_badarg(env);
     }
 
     Constraint constraint = builder_wrapper->p->AddLessOrEqual(*expr1->p, *expr2->p);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
-
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
-
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_greater_than_expr1_expr2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
@@ -564,33 +810,24 @@ extern "C"
     LinearExprWrapper *expr1;
     LinearExprWrapper *expr2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[1], &expr1))
+    if (!decode(env, argv[1], &expr1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[2], &expr2))
+    if (!decode(env, argv[2], &expr2))
     {
       return enif_make_badarg(env);
     }
 
     Constraint constraint = builder_wrapper->p->AddGreaterThan(*expr1->p, *expr2->p);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
-
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
-
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_greater_or_equal_expr1_expr2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
@@ -599,294 +836,443 @@ extern "C"
     LinearExprWrapper *expr1;
     LinearExprWrapper *expr2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[1], &expr1))
+    if (!decode(env, argv[1], &expr1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[2], &expr2))
+    if (!decode(env, argv[2], &expr2))
     {
       return enif_make_badarg(env);
     }
 
     Constraint constraint = builder_wrapper->p->AddGreaterOrEqual(*expr1->p, *expr2->p);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
+    return make_constraint(env, builder_wrapper, constraint);
+  }
+
+  ERL_NIF_TERM add_bool_and_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
       return enif_make_badarg(env);
+    }
 
-    constraint_wrapper->p = new Constraint(constraint);
+    std::vector<BoolVar> vars;
+    if (!decode_vars(env, argv[1], builder_wrapper->p, &vars))
+    {
+      return enif_make_badarg(env);
+    }
 
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
+    Constraint constraint = builder_wrapper->p->AddBoolAnd(vars);
 
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
-  ERL_NIF_TERM add_bool_and_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  ERL_NIF_TERM add_bool_or_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    unsigned int list_length;
-    if (!enif_get_list_length(env, argv[1], &list_length))
+    std::vector<BoolVar> vars;
+    if (!decode_vars(env, argv[1], builder_wrapper->p, &vars))
     {
       return enif_make_badarg(env);
     }
 
-    std::vector<BoolVar> vars;
-    ERL_NIF_TERM head;
-    ERL_NIF_TERM tail;
-    ERL_NIF_TERM current = argv[1];
-    for (int i = 0; i < list_length; ++i)
-    {
-      if (!enif_get_list_cell(env, current, &head, &tail))
-      {
-        return enif_make_badarg(env);
-      }
+    Constraint constraint = builder_wrapper->p->AddBoolOr(vars);
 
-      BoolVarWrapper *var;
-      if (!get_bool_var(env, head, &var))
-      {
-        return enif_make_badarg(env);
-      }
+    return make_constraint(env, builder_wrapper, constraint);
+  }
 
-      vars.push_back(*var->p);
+  ERL_NIF_TERM add_all_different_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
 
-      current = tail;
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
+      return enif_make_badarg(env);
     }
 
-    Constraint constraint = builder_wrapper->p->AddBoolAnd(vars);
-
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
+    std::vector<LinearExpr> vars;
+    if (!decode_vars(env, argv[1], builder_wrapper->p, &vars))
+    {
       return enif_make_badarg(env);
+    }
 
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
+    Constraint constraint = builder_wrapper->p->AddAllDifferent(vars);
 
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
-  ERL_NIF_TERM add_bool_or_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  ERL_NIF_TERM add_no_overlap_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    unsigned int list_length;
-    if (!enif_get_list_length(env, argv[1], &list_length))
+    std::vector<IntervalVar> vars;
+    if (!decode_vars(env, argv[1], builder_wrapper->p, &vars))
     {
       return enif_make_badarg(env);
     }
 
-    std::vector<BoolVar> vars;
-    ERL_NIF_TERM head;
-    ERL_NIF_TERM tail;
-    ERL_NIF_TERM current = argv[1];
-    for (int i = 0; i < list_length; ++i)
+    Constraint constraint = builder_wrapper->p->AddNoOverlap(vars);
+
+    return make_constraint(env, builder_wrapper, constraint);
+  }
+
+  // The tasks of a cumulative constraint: the indexes of their intervals and
+  // either fixed demands or demand expressions.
+  typedef struct
+  {
+    std::vector<int32_t> intervals;
+    std::vector<int64_t> demands;
+    std::vector<LinearExpr> exprs;
+  } CumulativeTasks;
+
+  // Decode `intervals`, a list of interval resources or a binary of their int32
+  // indexes, and `demands`, a list of integers, a binary of native int64 values
+  // or a list of expressions, one per interval.
+  static int get_cumulative_tasks(ErlNifEnv *env, CpModelBuilder *builder, ERL_NIF_TERM intervals_term, ERL_NIF_TERM demands_term, CumulativeTasks *tasks)
+  {
+    std::vector<IntervalVar> intervals;
+    if (!decode_vars(env, intervals_term, builder, &intervals))
     {
-      if (!enif_get_list_cell(env, current, &head, &tail))
-      {
-        return enif_make_badarg(env);
-      }
+      return 0;
+    }
 
-      BoolVarWrapper *var;
-      if (!get_bool_var(env, head, &var))
-      {
-        return enif_make_badarg(env);
-      }
+    tasks->intervals.reserve(intervals.size());
+    for (const IntervalVar &interval : intervals)
+    {
+      tasks->intervals.push_back(interval.index());
+    }
 
-      vars.push_back(*var->p);
+    if (decode(env, demands_term, &tasks->demands))
+    {
+      return tasks->demands.size() == tasks->intervals.size();
+    }
 
-      current = tail;
+    tasks->demands.clear();
+    return decode(env, demands_term, &tasks->exprs) && tasks->exprs.size() == tasks->intervals.size();
+  }
+
+  static void add_cumulative_tasks(Constraint *cumulative, const CumulativeTasks &tasks)
+  {
+    if (tasks.exprs.empty())
+    {
+      add_cumulative_demands(cumulative->MutableProto(), tasks.intervals.data(), tasks.demands.data(), tasks.intervals.size());
+      return;
     }
 
-    Constraint constraint = builder_wrapper->p->AddBoolOr(vars);
+    for (size_t i = 0; i < tasks.intervals.size(); ++i)
+    {
+      add_cumulative_demand(cumulative->MutableProto(), tasks.intervals[i], tasks.exprs[i]);
+    }
+  }
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
+  // add_cumulative_nif(builder, capacity, intervals, demands), where the
+  // capacity is an integer or an expression. More tasks may be added with
+  // `add_cumulative_demands_nif`. The arguments are all decoded before the
+  // constraint is added, so a bad argument leaves the builder unchanged.
+  ERL_NIF_TERM add_cumulative_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    LinearExpr capacity;
+    int64_t constant;
+    CumulativeTasks tasks;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
       return enif_make_badarg(env);
+    }
 
-    constraint_wrapper->p = new Constraint(constraint);
+    if (decode(env, argv[1], &constant))
+    {
+      capacity = LinearExpr(constant);
+    }
+    else if (!decode(env, argv[1], &capacity))
+    {
+      return enif_make_badarg(env);
+    }
 
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
+    if (!get_cumulative_tasks(env, builder_wrapper->p, argv[2], argv[3], &tasks))
+    {
+      return enif_make_badarg(env);
+    }
 
-    return term;
+    Constraint constraint = builder_wrapper->p->AddCumulative(capacity);
+    add_cumulative_tasks(&constraint, tasks);
+
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
-  ERL_NIF_TERM add_all_different_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  // add_cumulative_demands_nif(builder, cumulative, intervals, demands) adds
+  // tasks to a cumulative constraint of `builder` made by
+  // `add_cumulative_nif`, and returns the constraint.
+  ERL_NIF_TERM add_cumulative_demands_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
+    ConstraintWrapper *constraint_wrapper;
+    CumulativeTasks tasks;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    unsigned int list_length;
-    if (!enif_get_list_length(env, argv[1], &list_length))
+    if (!enif_get_resource(env, argv[1], CONSTRAINT_WRAPPER, (void **)&constraint_wrapper) ||
+        constraint_wrapper->builder != builder_wrapper->id ||
+        constraint_wrapper->p->Proto().constraint_case() != ConstraintProto::kCumulative)
     {
       return enif_make_badarg(env);
     }
 
-    std::vector<LinearExpr> vars;
-    ERL_NIF_TERM head;
-    ERL_NIF_TERM tail;
-    ERL_NIF_TERM current = argv[1];
-    for (int i = 0; i < list_length; ++i)
+    if (!get_cumulative_tasks(env, builder_wrapper->p, argv[2], argv[3], &tasks))
     {
-      if (!enif_get_list_cell(env, current, &head, &tail))
-      {
-        return enif_make_badarg(env);
-      }
+      return enif_make_badarg(env);
+    }
 
-      LinearExprWrapper *var;
-      if (!get_linear_expression(env, head, &var))
-      {
-        return enif_make_badarg(env);
-      }
+    add_cumulative_tasks(constraint_wrapper->p, tasks);
 
-      vars.push_back(*var->p);
+    return argv[1];
+  }
 
-      current = tail;
+  // A variable of a table: an integer or a boolean variable resource.
+  static int get_table_var(ErlNifEnv *env, ERL_NIF_TERM term, CpModelBuilder *builder, IntVar *var)
+  {
+    IntVarWrapper *int_var;
+    if (decode(env, term, &int_var))
+    {
+      *var = *int_var->p;
+      return 1;
     }
 
-    Constraint constraint = builder_wrapper->p->AddAllDifferent(vars);
+    BoolVarWrapper *bool_var;
+    if (!decode(env, term, &bool_var))
+    {
+      return 0;
+    }
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
+    // The integer variable of a negated literal is created in the builder the
+    // literal comes from. Take the literal from `builder` instead, so that a
+    // block never adds it to the model it was started from, which other blocks
+    // read concurrently.
+    int ref = bool_var->p->index();
+    int index = ref >= 0 ? ref : -ref - 1;
+    if (index >= builder->Proto().variables_size() || !is_boolean_var(builder->Proto(), index))
+    {
+      return 0;
+    }
 
-    constraint_wrapper->p = new Constraint(constraint);
+    BoolVar literal = builder->GetBoolVarFromProtoIndex(index);
+    *var = IntVar(ref >= 0 ? literal : literal.Not());
+    return 1;
+  }
 
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
+  // The variables of a table: a binary of int32 indexes, or a list of integer
+  // and boolean variable resources.
+  static int get_table_vars(ErlNifEnv *env, ERL_NIF_TERM term, CpModelBuilder *builder, std::vector<IntVar> *vars)
+  {
+    if (enif_is_binary(env, term))
+    {
+      return decode_vars(env, term, builder, vars);
+    }
 
-    return term;
+    auto decode_var = [builder](ErlNifEnv *env, ERL_NIF_TERM term, IntVar *var)
+    { return get_table_var(env, term, builder, var); };
+
+    return decode_list(env, term, vars, decode_var);
   }
 
-  ERL_NIF_TERM add_no_overlap_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  // add_allowed_assignments_nif(builder, vars, tuples) and
+  // add_forbidden_assignments_nif(builder, vars, tuples), where `tuples` is a
+  // binary of native int64 values, one row of `length(vars)` values per tuple.
+  // An aligned binary is read in place.
+  static ERL_NIF_TERM add_table(ErlNifEnv *env, const ERL_NIF_TERM argv[], bool negated)
   {
     BuilderWrapper *builder_wrapper;
+    std::vector<IntVar> vars;
+    Span<int64_t> tuples;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    unsigned int list_length;
-    if (!enif_get_list_length(env, argv[1], &list_length))
+    if (!get_table_vars(env, argv[1], builder_wrapper->p, &vars) || vars.empty())
     {
       return enif_make_badarg(env);
     }
 
-    std::vector<IntervalVar> vars;
-    ERL_NIF_TERM head;
-    ERL_NIF_TERM tail;
-    ERL_NIF_TERM current = argv[1];
-    for (int i = 0; i < list_length; ++i)
+    if (!decode(env, argv[2], &tuples) || tuples.size() % vars.size() != 0)
     {
-      if (!enif_get_list_cell(env, current, &head, &tail))
-      {
-        return enif_make_badarg(env);
-      }
-
-      IntervalVarWrapper *var;
-      if (!get_interval_var(env, head, &var))
-      {
-        return enif_make_badarg(env);
-      }
+      return enif_make_badarg(env);
+    }
 
-      vars.push_back(*var->p);
+    Constraint constraint = add_table_packed(builder_wrapper->p, vars, tuples.data(), tuples.size(), negated);
 
-      current = tail;
-    }
+    return make_constraint(env, builder_wrapper, constraint);
+  }
 
-    Constraint constraint = builder_wrapper->p->AddNoOverlap(vars);
+  ERL_NIF_TERM add_allowed_assignments_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    return add_table(env, argv, false);
+  }
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
+  ERL_NIF_TERM add_forbidden_assignments_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    return add_table(env, argv, true);
+  }
 
-    constraint_wrapper->p = new Constraint(constraint);
+  // Decode `{tail, head, literal}` tuples of BoolVar resources into packed
+  // (tail, head, literal ref) triples.
+  static int get_arc_list(ErlNifEnv *env, ERL_NIF_TERM term, std::vector<int32_t> *arcs)
+  {
+    ERL_NIF_TERM head;
+    ERL_NIF_TERM tail;
+    ERL_NIF_TERM current = term;
+    while (enif_get_list_cell(env, current, &head, &tail))
+    {
+      int arity;
+      const ERL_NIF_TERM *elements;
+      int32_t arc_tail;
+      int32_t arc_head;
+      BoolVarWrapper *literal;
+      if (!enif_get_tuple(env, head, &arity, &elements) || arity != 3 ||
+          !decode(env, elements[0], &arc_tail) ||
+          !decode(env, elements[1], &arc_head) ||
+          !decode(env, elements[2], &literal))
+      {
+        return 0;
+      }
 
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
+      arcs->push_back(arc_tail);
+      arcs->push_back(arc_head);
+      arcs->push_back(literal->p->index());
+      current = tail;
+    }
 
-    return term;
+    return enif_is_empty_list(env, current);
   }
 
-  ERL_NIF_TERM add_max_equality_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  // Whether `arcs` holds (tail, head, literal ref) triples of `builder`.
+  static int valid_arcs(CpModelBuilder *builder, const int32_t *arcs, size_t size)
   {
-    BuilderWrapper *builder_wrapper;
-    IntVarWrapper *var1;
-
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (size % 3 != 0)
     {
-      return enif_make_badarg(env);
+      return 0;
     }
 
-    if (!get_int_var(env, argv[1], &var1))
+    const CpModelProto &proto = builder->Proto();
+    for (size_t i = 0; i < size; i += 3)
     {
-      return enif_make_badarg(env);
+      int32_t index = arcs[i + 2] >= 0 ? arcs[i + 2] : -arcs[i + 2] - 1;
+      if (arcs[i] < 0 || arcs[i + 1] < 0 || index >= proto.variables_size() || !is_boolean_var(proto, index))
+      {
+        return 0;
+      }
     }
 
-    unsigned int list_length;
-    if (!enif_get_list_length(env, argv[2], &list_length))
+    return 1;
+  }
+
+  // add_circuit_nif(builder, arcs) and add_multiple_circuit_nif(builder, arcs),
+  // where `arcs` is a binary of native int32 (tail, head, literal ref) triples,
+  // read in place when aligned, or a list of `{tail, head, literal}` tuples.
+  // For literal refs, `-i - 1` is the negation of variable `i`.
+  static ERL_NIF_TERM add_circuit(ErlNifEnv *env, const ERL_NIF_TERM argv[], bool multiple)
+  {
+    BuilderWrapper *builder_wrapper;
+    Span<int32_t> packed;
+    std::vector<int32_t> listed;
+    const int32_t *arcs;
+    size_t size;
+
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    std::vector<IntVar> vars;
-    ERL_NIF_TERM head;
-    ERL_NIF_TERM tail;
-    ERL_NIF_TERM current = argv[2];
-    for (int i = 0; i < list_length; ++i)
+    if (enif_is_binary(env, argv[1]))
     {
-      if (!enif_get_list_cell(env, current, &head, &tail))
+      if (!decode(env, argv[1], &packed))
       {
         return enif_make_badarg(env);
       }
 
-      IntVarWrapper *var;
-      if (!get_int_var(env, head, &var))
+      arcs = packed.data();
+      size = packed.size();
+    }
+    else
+    {
+      if (!get_arc_list(env, argv[1], &listed))
       {
         return enif_make_badarg(env);
       }
 
-      vars.push_back(*var->p);
+      arcs = listed.data();
+      size = listed.size();
+    }
 
-      current = tail;
+    if (!valid_arcs(builder_wrapper->p, arcs, size))
+    {
+      return enif_make_badarg(env);
     }
 
-    Constraint constraint = builder_wrapper->p->AddMaxEquality(*var1->p, vars);
+    Constraint constraint = add_circuit_packed(builder_wrapper->p, arcs, size / 3, multiple);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
+    return make_constraint(env, builder_wrapper, constraint);
+  }
+
+  ERL_NIF_TERM add_circuit_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    return add_circuit(env, argv, false);
+  }
+
+  ERL_NIF_TERM add_multiple_circuit_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    return add_circuit(env, argv, true);
+  }
+
+  ERL_NIF_TERM add_max_equality_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    IntVarWrapper *var1;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
       return enif_make_badarg(env);
+    }
 
-    constraint_wrapper->p = new Constraint(constraint);
+    if (!decode(env, argv[1], &var1))
+    {
+      return enif_make_badarg(env);
+    }
 
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
+    std::vector<IntVar> vars;
+    if (!decode_vars(env, argv[2], builder_wrapper->p, &vars))
+    {
+      return enif_make_badarg(env);
+    }
 
-    return term;
+    Constraint constraint = builder_wrapper->p->AddMaxEquality(*var1->p, vars);
+
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_minimize_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
@@ -894,17 +1280,17 @@ extern "C"
     BuilderWrapper *builder_wrapper;
     LinearExprWrapper *expr1;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[1], &expr1))
+    if (!decode(env, argv[1], &expr1))
     {
       return enif_make_badarg(env);
     }
 
-    builder_wrapper->p->Minimize(*expr1->p);
+    builder_wrapper->p->Minimize(canonical_linear_expr(builder_wrapper->p, *expr1->p));
 
     return argv[0];
   }
@@ -914,17 +1300,17 @@ extern "C"
     BuilderWrapper *builder_wrapper;
     LinearExprWrapper *expr1;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[1], &expr1))
+    if (!decode(env, argv[1], &expr1))
     {
       return enif_make_badarg(env);
     }
 
-    builder_wrapper->p->Maximize(*expr1->p);
+    builder_wrapper->p->Maximize(canonical_linear_expr(builder_wrapper->p, *expr1->p));
 
     return argv[0];
   }
@@ -939,7 +1325,7 @@ extern "C"
       return enif_make_badarg(env);
     }
 
-    if (!get_bool_var(env, argv[1], &var))
+    if (!decode(env, argv[1], &var))
     {
       return enif_make_badarg(env);
     }
@@ -955,86 +1341,124 @@ extern "C"
     BoolVarWrapper *var1;
     BoolVarWrapper *var2;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_bool_var(env, argv[1], &var1))
+    if (!decode(env, argv[1], &var1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_bool_var(env, argv[2], &var2))
+    if (!decode(env, argv[2], &var2))
     {
       return enif_make_badarg(env);
     }
 
     Constraint constraint = builder_wrapper->p->AddImplication(*var1->p, *var2->p);
 
-    ConstraintWrapper *constraint_wrapper = (ConstraintWrapper *)enif_alloc_resource(CONSTRAINT_WRAPPER, sizeof(ConstraintWrapper));
-    if (constraint_wrapper == NULL)
-      return enif_make_badarg(env);
-
-    constraint_wrapper->p = new Constraint(constraint);
-
-    ERL_NIF_TERM term = enif_make_resource(env, constraint_wrapper);
-    enif_release_resource(constraint_wrapper);
-
-    return term;
+    return make_constraint(env, builder_wrapper, constraint);
   }
 
   ERL_NIF_TERM add_decision_strategy_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
-    vector<IntVar> *vars;
-    int variable_selection_strategy;
-    int domain_reduction_strategy;
+    vector<IntVar> vars;
+    int32_t variable_selection_strategy;
+    int32_t domain_reduction_strategy;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_int_var_list(env, argv[1], &vars))
+    if (!decode_vars(env, argv[1], builder_wrapper->p, &vars))
     {
       return enif_make_badarg(env);
     }
 
-    if (!enif_get_int(env, argv[2], &variable_selection_strategy))
+    if (!decode(env, argv[2], &variable_selection_strategy))
     {
       return enif_make_badarg(env);
     }
 
-    if (!enif_get_int(env, argv[3], &domain_reduction_strategy))
+    if (!decode(env, argv[3], &domain_reduction_strategy))
     {
       return enif_make_badarg(env);
     }
 
-    builder_wrapper->p->AddDecisionStrategy(*vars, static_cast<DecisionStrategyProto::VariableSelectionStrategy>(variable_selection_strategy), static_cast<DecisionStrategyProto::DomainReductionStrategy>(domain_reduction_strategy));
+    builder_wrapper->p->AddDecisionStrategy(vars, static_cast<DecisionStrategyProto::VariableSelectionStrategy>(variable_selection_strategy), static_cast<DecisionStrategyProto::DomainReductionStrategy>(domain_reduction_strategy));
 
     return argv[0];
   }
 
+  ERL_NIF_TERM put_solve_stats(ErlNifEnv *env, ERL_NIF_TERM result, const CpSolverResponse &response, SolveMonitor *monitor, WorkerStats *stats)
+  {
+    if (monitor != NULL)
+    {
+      monitor->Finish();
+
+      const char *stop_reason = monitor->StopReason(response);
+      if (stop_reason != NULL)
+      {
+        result = put_map_value(env, result, "stop_reason", enif_make_atom(env, stop_reason));
+      }
+    }
+
+    if (stats != NULL)
+    {
+      result = put_map_value(env, result, "workers", stats->MakeTerm(env));
+    }
+
+    return result;
+  }
+
+  ERL_NIF_TERM make_solve_result(ErlNifEnv *env, const CpSolverResponse &response, SolveMonitor *monitor, WorkerStats *stats)
+  {
+    return put_solve_stats(env, make_cp_solver_response(env, response), response, monitor, stats);
+  }
+
   ERL_NIF_TERM solve_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
+    SolveOptions options;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
 
-    CpSolverResponse response = Solve(builder_wrapper->p->Build());
+    if (!get_solve_options(env, argv[1], &options))
+    {
+      return enif_make_badarg(env);
+    }
 
-    return make_cp_solver_response(env, response);
+    Model model;
+    SatParameters parameters;
+    apply_solve_options(options, &parameters);
+    model.Add(NewSatParameters(parameters));
+    const CpModelProto &proto = builder_wrapper->p->Build();
+    track_native_memory(BUILDER_MEMORY, &builder_wrapper->bytes, proto.SpaceUsedLong());
+    unique_ptr<LogStream> log_stream = attach_log_stream(env, options, &model);
+    unique_ptr<SolveMonitor> monitor = attach_solve_monitor(options, proto, &model);
+    unique_ptr<WorkerStats> stats = attach_worker_stats(options, &model);
+    unique_ptr<SolveProbes> probes = attach_solve_probes(proto, &model);
+
+    CpSolverResponse response = SolveCpModel(proto, &model);
+    if (probes)
+    {
+      probes->Finish(response);
+    }
+    return make_solve_result(env, response, monitor.get(), stats.get());
   }
 
   ERL_NIF_TERM solve_with_callback_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BuilderWrapper *builder_wrapper;
+    SolveOptions options;
 
-    if (!enif_get_resource(env, argv[0], CP_MODEL_BUILDER_WRAPPER, (void **)&builder_wrapper))
+    if (!decode(env, argv[0], &builder_wrapper))
     {
       return enif_make_badarg(env);
     }
@@ -1042,18 +1466,34 @@ extern "C"
     ErlNifPid pid;
     enif_get_local_pid(env, argv[1], &pid);
 
+    if (!get_solve_options(env, argv[2], &options))
+    {
+      return enif_make_badarg(env);
+    }
+
     Model model;
     SatParameters parameters;
     parameters.set_search_branching(SatParameters::FIXED_SEARCH);
     parameters.set_enumerate_all_solutions(true);
+    apply_solve_options(options, &parameters);
     model.Add(NewSatParameters(parameters));
     model.Add(NewFeasibleSolutionObserver([&](const CpSolverResponse &r)
                                           {
                                             ERL_NIF_TERM term = make_cp_solver_response(env, r);
                                             enif_send(env, &pid, NULL, term); }));
+    const CpModelProto &proto = builder_wrapper->p->Build();
+    track_native_memory(BUILDER_MEMORY, &builder_wrapper->bytes, proto.SpaceUsedLong());
+    unique_ptr<LogStream> log_stream = attach_log_stream(env, options, &model);
+    unique_ptr<SolveMonitor> monitor = attach_solve_monitor(options, proto, &model);
+    unique_ptr<WorkerStats> stats = attach_worker_stats(options, &model);
+    unique_ptr<SolveProbes> probes = attach_solve_probes(proto, &model);
 
-    CpSolverResponse response = SolveCpModel(builder_wrapper->p->Build(), &model);
-    return make_cp_solver_response(env, response);
+    CpSolverResponse response = SolveCpModel(proto, &model);
+    if (probes)
+    {
+      probes->Finish(response);
+    }
+    return make_solve_result(env, response, monitor.get(), stats.get());
   }
 
   ERL_NIF_TERM solution_bool_value_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
@@ -1061,12 +1501,12 @@ extern "C"
     CpSolverResponseWrapper *response;
     BoolVarWrapper *var;
 
-    if (!get_cp_solver_response(env, argv[0], &response))
+    if (!decode(env, argv[0], &response))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_bool_var(env, argv[1], &var))
+    if (!decode(env, argv[1], &var))
     {
       return enif_make_badarg(env);
     }
@@ -1081,12 +1521,12 @@ extern "C"
     CpSolverResponseWrapper *response;
     IntVarWrapper *var;
 
-    if (!get_cp_solver_response(env, argv[0], &response))
+    if (!decode(env, argv[0], &response))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_int_var(env, argv[1], &var))
+    if (!decode(env, argv[1], &var))
     {
       return enif_make_badarg(env);
     }
@@ -2,13 +2,32 @@
 #define __CP_MODEL_BUILDER_H__
 
 #include "erl_nif.h"
+#include "solve_monitor.h"
+#include "worker_stats.h"
+#include "wrappers.h"
 
 extern "C"
 {
   int load_cp_model_builder(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
 
+  int get_cp_model_builder(ErlNifEnv *env, ERL_NIF_TERM term, BuilderWrapper **obj);
+
+  // Put the `stop_reason` found by `monitor` and the `workers` collected by
+  // `stats` for a finished solve in the map `result`. Either may be NULL.
+  ERL_NIF_TERM put_solve_stats(ErlNifEnv *env, ERL_NIF_TERM result, const CpSolverResponse &response, SolveMonitor *monitor, WorkerStats *stats);
+
+  // Make the response map of a finished solve with its `put_solve_stats`.
+  ERL_NIF_TERM make_solve_result(ErlNifEnv *env, const CpSolverResponse &response, SolveMonitor *monitor, WorkerStats *stats);
+
+  // Make a builder resource that takes ownership of `builder`.
+  ERL_NIF_TERM make_cp_model_builder(ErlNifEnv *env, CpModelBuilder *builder);
+
   ERL_NIF_TERM new_builder_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 
+  ERL_NIF_TERM new_sub_builder_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM merge_builders_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
   ERL_NIF_TERM new_bool_var_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 
   ERL_NIF_TERM new_int_var_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
@@ -19,6 +38,10 @@ extern "C"
 
   ERL_NIF_TERM new_optional_interval_var_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 
+  ERL_NIF_TERM new_fixed_size_interval_var_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM new_optional_fixed_size_interval_var_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
   ERL_NIF_TERM add_abs_equal_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 
   ERL_NIF_TERM add_abs_equal_constant_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
@@ -35,6 +58,18 @@ extern "C"
 
   ERL_NIF_TERM add_no_overlap_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 
+  ERL_NIF_TERM add_cumulative_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM add_cumulative_demands_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM add_allowed_assignments_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM add_forbidden_assignments_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM add_circuit_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM add_multiple_circuit_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
   ERL_NIF_TERM add_equal_int_var_plus_int_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 
   ERL_NIF_TERM add_equal_expr1_expr2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
@@ -1,7 +1,9 @@
 #include <cstring>
+#include <new>
 #include <string.h>
 #include "erl_nif.h"
 #include "ortools/sat/cp_model.h"
+#include "native_memory.h"
 #include "wrappers.h"
 
 using namespace std;
@@ -15,7 +17,9 @@ extern "C"
   static void free_solver_response(ErlNifEnv *env, void *obj)
   {
     CpSolverResponseWrapper *w = (CpSolverResponseWrapper *)obj;
+    track_native_memory(RESPONSE_MEMORY, &w->bytes, 0);
     delete w->p;
+    release_native_resource(RESPONSE_RESOURCE, sizeof(CpSolverResponse));
   }
 
   static int init_types(ErlNifEnv *env)
@@ -36,6 +40,9 @@ extern "C"
       return enif_make_badarg(env);
 
     cp_solver_response_wrapper->p = new CpSolverResponse(from);
+    count_native_resource(RESPONSE_RESOURCE, sizeof(CpSolverResponse));
+    new (&cp_solver_response_wrapper->bytes) atomic<size_t>(0);
+    track_native_memory(RESPONSE_MEMORY, &cp_solver_response_wrapper->bytes, cp_solver_response_wrapper->p->SpaceUsedLong());
     ERL_NIF_TERM term = enif_make_resource(env, cp_solver_response_wrapper);
     enif_release_resource(cp_solver_response_wrapper);
 
@@ -57,6 +64,11 @@ extern "C"
     keys.push_back(enif_make_binary(env, &objective));
     values.push_back(enif_make_double(env, from.objective_value()));
 
+    const char *best_bound_key = "best_bound";
+    ErlNifBinary best_bound = {.size = strlen(best_bound_key), .data = (unsigned char *)best_bound_key};
+    keys.push_back(enif_make_binary(env, &best_bound));
+    values.push_back(enif_make_double(env, from.best_objective_bound()));
+
     const char *walltime_key = "walltime";
     ErlNifBinary walltime = {.size = strlen(walltime_key), .data = (unsigned char *)walltime_key};
     keys.push_back(enif_make_binary(env, &walltime));
@@ -67,6 +79,28 @@ extern "C"
     keys.push_back(enif_make_binary(env, &usertime));
     values.push_back(enif_make_double(env, from.user_time()));
 
+    const char *deterministic_time_key = "deterministic_time";
+    ErlNifBinary deterministic_time = {.size = strlen(deterministic_time_key), .data = (unsigned char *)deterministic_time_key};
+    keys.push_back(enif_make_binary(env, &deterministic_time));
+    values.push_back(enif_make_double(env, from.deterministic_time()));
+
+    const char *num_branches_key = "num_branches";
+    ErlNifBinary num_branches = {.size = strlen(num_branches_key), .data = (unsigned char *)num_branches_key};
+    keys.push_back(enif_make_binary(env, &num_branches));
+    values.push_back(enif_make_int64(env, from.num_branches()));
+
+    const char *num_conflicts_key = "num_conflicts";
+    ErlNifBinary num_conflicts = {.size = strlen(num_conflicts_key), .data = (unsigned char *)num_conflicts_key};
+    keys.push_back(enif_make_binary(env, &num_conflicts));
+    values.push_back(enif_make_int64(env, from.num_conflicts()));
+
+    const char *solution_info_key = "solution_info";
+    ErlNifBinary solution_info = {.size = strlen(solution_info_key), .data = (unsigned char *)solution_info_key};
+    keys.push_back(enif_make_binary(env, &solution_info));
+    ERL_NIF_TERM solution_info_value;
+    memcpy(enif_make_new_binary(env, from.solution_info().size(), &solution_info_value), from.solution_info().data(), from.solution_info().size());
+    values.push_back(solution_info_value);
+
     ERL_NIF_TERM key_array[keys.size()];
     std::copy(keys.begin(), keys.end(), key_array);
 
@@ -0,0 +1,345 @@
+#ifndef __DECODE_H__
+#define __DECODE_H__
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "absl/types/span.h"
+#include "erl_nif.h"
+#include "wrappers.h"
+#include "bool_var.h"
+#include "cp_model_builder.h"
+#include "cp_solver_response.h"
+#include "int_var.h"
+#include "interval_var.h"
+#include "linear_expression.h"
+#include "utility.h"
+#include "core/model_assembly.h"
+
+// Decoding of NIF arguments into C++ values.
+//
+// `decode(env, term, &value)` reads `term` into `value` and, like the
+// `enif_get_*` functions, returns 0 when `term` does not have the expected
+// shape. Integers are read as int64 throughout.
+//
+// A `std::vector<T>` is decoded from a list, reserving from its length, or,
+// for integers, from a binary of native-endian values. A `Span<T>` of
+// integers refers into such a binary without copying it, and only falls back
+// to its own storage for a list or an unaligned binary.
+//
+// `decode_vars` and `decode_var_indexes` also accept a binary of native int32
+// model indexes for the variables of a model.
+
+template <typename T>
+struct Decoder;
+
+template <typename T>
+inline int decode(ErlNifEnv *env, ERL_NIF_TERM term, T *value)
+{
+  return Decoder<T>::decode(env, term, value);
+}
+
+template <>
+struct Decoder<int64_t>
+{
+  static int decode(ErlNifEnv *env, ERL_NIF_TERM term, int64_t *value)
+  {
+    ErlNifSInt64 v;
+    if (!enif_get_int64(env, term, &v))
+    {
+      return 0;
+    }
+
+    *value = v;
+    return 1;
+  }
+};
+
+template <>
+struct Decoder<int32_t>
+{
+  static int decode(ErlNifEnv *env, ERL_NIF_TERM term, int32_t *value)
+  {
+    return enif_get_int(env, term, value);
+  }
+};
+
+template <>
+struct Decoder<double>
+{
+  static int decode(ErlNifEnv *env, ERL_NIF_TERM term, double *value)
+  {
+    return enif_get_double(env, term, value);
+  }
+};
+
+template <>
+struct Decoder<BuilderWrapper *>
+{
+  static int decode(ErlNifEnv *env, ERL_NIF_TERM term, BuilderWrapper **value)
+  {
+    return get_cp_model_builder(env, term, value);
+  }
+};
+
+// Other resources decode to their wrapper, or to a copy of the wrapped value.
+#define DECODE_RESOURCE(Wrapper, Value, get)                                \
+  template <>                                                               \
+  struct Decoder<Wrapper *>                                                 \
+  {                                                                         \
+    static int decode(ErlNifEnv *env, ERL_NIF_TERM term, Wrapper **value)   \
+    {                                                                       \
+      return get(env, term, value);                                         \
+    }                                                                       \
+  };                                                                        \
+                                                                            \
+  template <>                                                               \
+  struct Decoder<Value>                                                     \
+  {                                                                         \
+    static int decode(ErlNifEnv *env, ERL_NIF_TERM term, Value *value)      \
+    {                                                                       \
+      Wrapper *wrapper;                                                     \
+      if (!get(env, term, &wrapper))                                        \
+      {                                                                     \
+        return 0;                                                           \
+      }                                                                     \
+                                                                            \
+      *value = *wrapper->p;                                                 \
+      return 1;                                                             \
+    }                                                                       \
+  };
+
+DECODE_RESOURCE(BoolVarWrapper, BoolVar, get_bool_var)
+DECODE_RESOURCE(IntVarWrapper, IntVar, get_int_var)
+DECODE_RESOURCE(IntervalVarWrapper, IntervalVar, get_interval_var)
+DECODE_RESOURCE(LinearExprWrapper, LinearExpr, get_linear_expression)
+DECODE_RESOURCE(CpSolverResponseWrapper, CpSolverResponse, get_cp_solver_response)
+
+#undef DECODE_RESOURCE
+
+// Append each element of a list to `values`, decoded with `decode_one`.
+template <typename T, typename F>
+int decode_list(ErlNifEnv *env, ERL_NIF_TERM term, std::vector<T> *values, F decode_one)
+{
+  unsigned int length;
+  if (!enif_get_list_length(env, term, &length))
+  {
+    return 0;
+  }
+
+  values->reserve(values->size() + length);
+
+  ERL_NIF_TERM head;
+  ERL_NIF_TERM tail;
+  ERL_NIF_TERM current = term;
+  while (enif_get_list_cell(env, current, &head, &tail))
+  {
+    values->emplace_back();
+    if (!decode_one(env, head, &values->back()))
+    {
+      return 0;
+    }
+
+    current = tail;
+  }
+
+  return 1;
+}
+
+template <typename T>
+struct Decoder<std::vector<T>>
+{
+  static int decode(ErlNifEnv *env, ERL_NIF_TERM term, std::vector<T> *values)
+  {
+    if constexpr (std::is_arithmetic<T>::value)
+    {
+      ErlNifBinary binary;
+      if (enif_inspect_binary(env, term, &binary))
+      {
+        if (binary.size % sizeof(T) != 0)
+        {
+          return 0;
+        }
+
+        size_t offset = values->size();
+        values->resize(offset + binary.size / sizeof(T));
+        memcpy(values->data() + offset, binary.data, binary.size);
+        return 1;
+      }
+    }
+
+    return decode_list(env, term, values, Decoder<T>::decode);
+  }
+};
+
+// A read-only run of integers decoded from a binary or a list.
+template <typename T>
+class Span
+{
+public:
+  Span() : data_(NULL), size_(0) {}
+  Span(const Span &) = delete;
+  Span &operator=(const Span &) = delete;
+
+  const T *data() const { return data_; }
+  size_t size() const { return size_; }
+  const T &operator[](size_t i) const { return data_[i]; }
+
+  operator absl::Span<const T>() const { return absl::Span<const T>(data_, size_); }
+
+private:
+  friend struct Decoder<Span<T>>;
+
+  const T *data_;
+  size_t size_;
+  std::vector<T> storage_;
+};
+
+template <typename T>
+struct Decoder<Span<T>>
+{
+  static_assert(std::is_arithmetic<T>::value, "a Span holds integers or floats");
+
+  static int decode(ErlNifEnv *env, ERL_NIF_TERM term, Span<T> *span)
+  {
+    ErlNifBinary binary;
+    if (enif_inspect_binary(env, term, &binary) &&
+        binary.size % sizeof(T) == 0 &&
+        (uintptr_t)binary.data % alignof(T) == 0)
+    {
+      span->data_ = (const T *)binary.data;
+      span->size_ = binary.size / sizeof(T);
+      return 1;
+    }
+
+    span->storage_.clear();
+    if (!Decoder<std::vector<T>>::decode(env, term, &span->storage_))
+    {
+      return 0;
+    }
+
+    span->data_ = span->storage_.data();
+    span->size_ = span->storage_.size();
+    return 1;
+  }
+};
+
+// Check the model indexes of a packed binary against the variables of
+// `builder` and look the variables up.
+inline int vars_from_indexes(CpModelBuilder *builder, const Span<int32_t> &indexes, std::vector<IntVar> *vars)
+{
+  int size = builder->Proto().variables_size();
+  for (size_t i = 0; i < indexes.size(); ++i)
+  {
+    if (indexes[i] < 0 || indexes[i] >= size)
+    {
+      return 0;
+    }
+  }
+
+  int_vars_from_indexes(builder, indexes.data(), indexes.size(), vars);
+  return 1;
+}
+
+inline int vars_from_indexes(CpModelBuilder *builder, const Span<int32_t> &indexes, std::vector<LinearExpr> *exprs)
+{
+  std::vector<IntVar> vars;
+  if (!vars_from_indexes(builder, indexes, &vars))
+  {
+    return 0;
+  }
+
+  exprs->reserve(exprs->size() + vars.size());
+  for (const IntVar &var : vars)
+  {
+    exprs->emplace_back(var);
+  }
+
+  return 1;
+}
+
+inline int vars_from_indexes(CpModelBuilder *builder, const Span<int32_t> &refs, std::vector<BoolVar> *vars)
+{
+  const CpModelProto &proto = builder->Proto();
+  for (size_t i = 0; i < refs.size(); ++i)
+  {
+    int32_t index = refs[i] >= 0 ? refs[i] : -refs[i] - 1;
+    if (index >= proto.variables_size() || !is_boolean_var(proto, index))
+    {
+      return 0;
+    }
+  }
+
+  bool_vars_from_refs(builder, refs.data(), refs.size(), vars);
+  return 1;
+}
+
+inline int vars_from_indexes(CpModelBuilder *builder, const Span<int32_t> &indexes, std::vector<IntervalVar> *vars)
+{
+  const CpModelProto &proto = builder->Proto();
+  vars->reserve(vars->size() + indexes.size());
+  for (size_t i = 0; i < indexes.size(); ++i)
+  {
+    if (indexes[i] < 0 || indexes[i] >= proto.constraints_size() || !proto.constraints(indexes[i]).has_interval())
+    {
+      return 0;
+    }
+
+    vars->push_back(builder->GetIntervalVarFromProtoIndex(indexes[i]));
+  }
+
+  return 1;
+}
+
+// Decode a list of variable resources, or a binary of the native int32 model
+// indexes of variables of `builder`. For boolean variables, `-i - 1` is the
+// negation of variable `i`; for interval variables, the index is that of the
+// interval constraint.
+template <typename T>
+int decode_vars(ErlNifEnv *env, ERL_NIF_TERM term, CpModelBuilder *builder, std::vector<T> *vars)
+{
+  if (enif_is_binary(env, term))
+  {
+    Span<int32_t> indexes;
+    return decode(env, term, &indexes) && vars_from_indexes(builder, indexes, vars);
+  }
+
+  return decode(env, term, vars);
+}
+
+// Decode a list of integer or boolean variable resources, or a binary of
+// native int32 model indexes below `num_vars`, into model variable indexes. A
+// negated boolean refers to the index of its positive literal.
+inline int decode_var_indexes(ErlNifEnv *env, ERL_NIF_TERM term, int num_vars, std::vector<int> *indexes)
+{
+  size_t first = indexes->size();
+
+  if (enif_is_binary(env, term))
+  {
+    Span<int32_t> span;
+    if (!decode(env, term, &span))
+    {
+      return 0;
+    }
+
+    indexes->insert(indexes->end(), span.data(), span.data() + span.size());
+  }
+  else if (!decode_list(env, term, indexes, get_var_index))
+  {
+    return 0;
+  }
+
+  // A variable resource of another builder may be past this model's variables.
+  for (size_t i = first; i < indexes->size(); ++i)
+  {
+    if ((*indexes)[i] < 0 || (*indexes)[i] >= num_vars)
+    {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+#endif
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/model.h"
+#include "ortools/sat/sat_parameters.pb.h"
+#include "wrappers.h"
+#include "cp_model_builder.h"
+#include "cp_solver_response.h"
+#include "log_stream.h"
+#include "native_memory.h"
+#include "solve_options.h"
+#include "utility.h"
+#include "decode.h"
+
+using operations_research::sat::CpModelProto;
+using operations_research::sat::CpSolverResponse;
+using operations_research::sat::IntegerVariableProto;
+using operations_research::sat::Model;
+using operations_research::sat::NewSatParameters;
+using operations_research::sat::SatParameters;
+
+using namespace std;
+
+// Large neighbourhood search over a built model.
+//
+// Starting from a feasible response, each iteration picks a neighbourhood of
+// variables, fixes every other variable to its value in the best solution so
+// far and re-solves the restricted model for a short time. The restricted
+// model keeps the variable indices of the original model, so the responses it
+// produces may be read with the model's variable handles.
+
+extern "C"
+{
+  static ERL_NIF_TERM atom_random;
+  static ERL_NIF_TERM atom_groups;
+  static ERL_NIF_TERM atom_iterations;
+  static ERL_NIF_TERM atom_iteration_time_limit;
+  static ERL_NIF_TERM atom_seed;
+  static ERL_NIF_TERM atom_exhort_improve;
+
+  typedef struct
+  {
+    unsigned int iterations;
+    double iteration_time_limit;
+    unsigned int seed;
+  } ImproveOptions;
+
+  static int init_atoms(ErlNifEnv *env)
+  {
+    atom_random = enif_make_atom(env, "random");
+    atom_groups = enif_make_atom(env, "groups");
+    atom_iterations = enif_make_atom(env, "iterations");
+    atom_iteration_time_limit = enif_make_atom(env, "iteration_time_limit");
+    atom_seed = enif_make_atom(env, "seed");
+    atom_exhort_improve = enif_make_atom(env, "exhort_improve");
+    return 0;
+  }
+
+  static int get_improve_options(ErlNifEnv *env, ERL_NIF_TERM term, ImproveOptions *options)
+  {
+    options->iterations = 100;
+    options->iteration_time_limit = 1.0;
+    options->seed = 0;
+
+    ERL_NIF_TERM value;
+    if (enif_get_map_value(env, term, atom_iterations, &value) &&
+        !enif_get_uint(env, value, &options->iterations))
+    {
+      return 0;
+    }
+
+    if (enif_get_map_value(env, term, atom_iteration_time_limit, &value) &&
+        !enif_get_double(env, value, &options->iteration_time_limit))
+    {
+      int64_t seconds;
+      if (!decode(env, value, &seconds))
+      {
+        return 0;
+      }
+      options->iteration_time_limit = seconds;
+    }
+
+    if (enif_get_map_value(env, term, atom_seed, &value) &&
+        !enif_get_uint(env, value, &options->seed))
+    {
+      return 0;
+    }
+
+    return 1;
+  }
+
+  // Decode `{:random, fraction}` or `{:groups, [[var]]}`. A random
+  // neighbourhood is returned as a size; groups are returned as lists of
+  // variable indices.
+  static int get_neighbourhood(ErlNifEnv *env, ERL_NIF_TERM term, int num_vars, size_t *random_size, vector<vector<int>> *groups)
+  {
+    const ERL_NIF_TERM *spec;
+    int arity;
+
+    if (!enif_get_tuple(env, term, &arity, &spec) || arity != 2)
+    {
+      return 0;
+    }
+
+    if (enif_is_identical(spec[0], atom_random))
+    {
+      double fraction;
+      if (!enif_get_double(env, spec[1], &fraction) || fraction <= 0 || fraction > 1)
+      {
+        return 0;
+      }
+
+      *random_size = max((size_t)1, (size_t)(fraction * num_vars));
+      return 1;
+    }
+
+    if (enif_is_identical(spec[0], atom_groups))
+    {
+      auto decode_group = [num_vars](ErlNifEnv *env, ERL_NIF_TERM term, vector<int> *group)
+      { return decode_var_indexes(env, term, num_vars, group); };
+
+      return decode_list(env, spec[1], groups, decode_group) && !groups->empty();
+    }
+
+    return 0;
+  }
+
+  static bool has_solution(const CpSolverResponse &response)
+  {
+    return response.status() == operations_research::sat::FEASIBLE ||
+           response.status() == operations_research::sat::OPTIMAL;
+  }
+
+  static bool is_better(const CpModelProto &model, const CpSolverResponse &candidate, const CpSolverResponse &best)
+  {
+    if (!has_solution(candidate))
+    {
+      return false;
+    }
+
+    // A maximization is stored as the minimization of the negated objective
+    // with a negative scaling factor.
+    if (model.objective().scaling_factor() < 0)
+    {
+      return candidate.objective_value() > best.objective_value();
+    }
+
+    return candidate.objective_value() < best.objective_value();
+  }
+
+  // Restrict `model` to `neighbourhood`: every other variable is fixed to its
+  // value in `incumbent`, and the free variables are hinted with theirs.
+  static void fix_outside(CpModelProto *model, const vector<bool> &neighbourhood, const CpSolverResponse &incumbent)
+  {
+    model->clear_solution_hint();
+
+    for (int i = 0; i < model->variables_size(); ++i)
+    {
+      int64_t value = incumbent.solution(i);
+
+      if (neighbourhood[i])
+      {
+        model->mutable_solution_hint()->add_vars(i);
+        model->mutable_solution_hint()->add_values(value);
+        continue;
+      }
+
+      IntegerVariableProto *var = model->mutable_variables(i);
+      var->clear_domain();
+      var->add_domain(value);
+      var->add_domain(value);
+    }
+  }
+
+  // `walltime` is the time since `started_at`, the start of the improvement
+  // loop, rather than that of the iteration's solve.
+  static void send_improvement(ErlNifEnv *env, const ErlNifPid &pid, unsigned int iteration, const CpSolverResponse &best,
+                               chrono::steady_clock::time_point started_at)
+  {
+    chrono::duration<double> walltime = chrono::steady_clock::now() - started_at;
+
+    ERL_NIF_TERM progress = enif_make_new_map(env);
+    progress = put_map_value(env, progress, "iteration", enif_make_uint(env, iteration));
+    progress = put_map_value(env, progress, "objective", enif_make_double(env, best.objective_value()));
+    progress = put_map_value(env, progress, "walltime", enif_make_double(env, walltime.count()));
+
+    enif_send(env, &pid, NULL, enif_make_tuple2(env, atom_exhort_improve, progress));
+  }
+
+  ERL_NIF_TERM improve_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    chrono::steady_clock::time_point started_at = chrono::steady_clock::now();
+    BuilderWrapper *builder_wrapper;
+    CpSolverResponseWrapper *response_wrapper;
+    SolveOptions options;
+    ImproveOptions improve_options;
+    size_t random_size = 0;
+    vector<vector<int>> groups;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!decode(env, argv[1], &response_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    const CpModelProto &model = builder_wrapper->p->Build();
+    int num_vars = model.variables_size();
+    track_native_memory(BUILDER_MEMORY, &builder_wrapper->bytes, model.SpaceUsedLong());
+
+    if (!get_neighbourhood(env, argv[2], num_vars, &random_size, &groups))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!get_solve_options(env, argv[3], &options) ||
+        !get_improve_options(env, argv[3], &improve_options))
+    {
+      return enif_make_badarg(env);
+    }
+
+    CpSolverResponse best = *response_wrapper->p;
+    if (num_vars == 0 || !has_solution(best) || best.solution_size() != num_vars)
+    {
+      return make_cp_solver_response(env, best);
+    }
+
+    mt19937 random(improve_options.seed);
+    vector<int> indexes(num_vars);
+    for (int i = 0; i < num_vars; ++i)
+    {
+      indexes[i] = i;
+    }
+
+    unsigned int improvements = 0;
+    vector<bool> neighbourhood(num_vars);
+    for (unsigned int iteration = 1; iteration <= improve_options.iterations; ++iteration)
+    {
+      fill(neighbourhood.begin(), neighbourhood.end(), false);
+
+      if (groups.empty())
+      {
+        for (size_t i = 0; i < random_size; ++i)
+        {
+          uniform_int_distribution<size_t> pick(i, num_vars - 1);
+          swap(indexes[i], indexes[pick(random)]);
+          neighbourhood[indexes[i]] = true;
+        }
+      }
+      else
+      {
+        uniform_int_distribution<size_t> pick(0, groups.size() - 1);
+        for (int index : groups[pick(random)])
+        {
+          neighbourhood[index] = true;
+        }
+      }
+
+      CpModelProto restricted = model;
+      fix_outside(&restricted, neighbourhood, best);
+
+      Model solver;
+      SatParameters parameters;
+      apply_solve_options(options, &parameters);
+      parameters.set_max_time_in_seconds(improve_options.iteration_time_limit);
+      parameters.set_random_seed(iteration);
+      solver.Add(NewSatParameters(parameters));
+      unique_ptr<LogStream> log_stream = attach_log_stream(env, options, &solver);
+
+      CpSolverResponse candidate = SolveCpModel(restricted, &solver);
+
+      if (is_better(model, candidate, best))
+      {
+        // The candidate is only proven optimal within its neighbourhood.
+        candidate.set_status(operations_research::sat::FEASIBLE);
+        best = candidate;
+        ++improvements;
+
+        if (options.has_progress_pid)
+        {
+          send_improvement(env, options.progress_pid, iteration, best, started_at);
+        }
+      }
+    }
+
+    ERL_NIF_TERM result = make_cp_solver_response(env, best);
+    result = put_map_value(env, result, "improvements", enif_make_uint(env, improvements));
+
+    return result;
+  }
+
+  int load_improve(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
+  {
+    if (init_atoms(env) == -1)
+      return -1;
+    else
+      return 0;
+  }
+}
@@ -0,0 +1,13 @@
+#ifndef __IMPROVE_H__
+#define __IMPROVE_H__
+
+#include "erl_nif.h"
+
+extern "C"
+{
+  int load_improve(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
+
+  ERL_NIF_TERM improve_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+}
+
+#endif
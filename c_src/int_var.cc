@@ -2,6 +2,7 @@
 #include "erl_nif.h"
 #include "ortools/sat/cp_model.h"
 #include "wrappers.h"
+#include "native_memory.h"
 
 extern "C"
 {
@@ -11,6 +12,7 @@ extern "C"
   {
     IntVarWrapper *w = (IntVarWrapper *)obj;
     delete w->p;
+    release_native_resource(INT_VAR_RESOURCE, sizeof(IntVar));
   }
 
   static int init_types(ErlNifEnv *env)
@@ -31,6 +33,7 @@ extern "C"
       return enif_make_badarg(env);
 
     int_var_wrapper->p = new IntVar(from_int_var);
+    count_native_resource(INT_VAR_RESOURCE, sizeof(IntVar));
     ERL_NIF_TERM term = enif_make_resource(env, int_var_wrapper);
     enif_release_resource(int_var_wrapper);
 
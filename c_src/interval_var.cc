@@ -2,6 +2,7 @@
 #include "erl_nif.h"
 #include "ortools/sat/cp_model.h"
 #include "wrappers.h"
+#include "native_memory.h"
 
 extern "C"
 {
@@ -11,6 +12,7 @@ extern "C"
   {
     IntervalVarWrapper *w = (IntervalVarWrapper *)obj;
     delete w->p;
+    release_native_resource(INTERVAL_VAR_RESOURCE, sizeof(IntervalVar));
   }
 
   static int init_types(ErlNifEnv *env)
@@ -31,6 +33,7 @@ extern "C"
       return enif_make_badarg(env);
 
     interval_var_wrapper->p = new IntervalVar(from_var);
+    count_native_resource(INTERVAL_VAR_RESOURCE, sizeof(IntervalVar));
     ERL_NIF_TERM term = enif_make_resource(env, interval_var_wrapper);
     enif_release_resource(interval_var_wrapper);
 
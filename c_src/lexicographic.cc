@@ -0,0 +1,221 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/model.h"
+#include "ortools/sat/sat_parameters.pb.h"
+#include "wrappers.h"
+#include "cp_model_builder.h"
+#include "cp_solver_response.h"
+#include "linear_expression.h"
+#include "log_stream.h"
+#include "native_memory.h"
+#include "solve_options.h"
+#include "utility.h"
+#include "decode.h"
+
+using operations_research::sat::ConstraintProto;
+using operations_research::sat::CpModelProto;
+using operations_research::sat::CpSolverResponse;
+using operations_research::sat::LinearConstraintProto;
+using operations_research::sat::LinearExpr;
+using operations_research::sat::Model;
+using operations_research::sat::NewSatParameters;
+using operations_research::sat::SatParameters;
+
+using namespace std;
+
+// Lexicographic optimization of an ordered list of objectives.
+//
+// Each objective is optimized in turn on a copy of the built model. Once a
+// stage is solved its objective is pinned to the value found, within the
+// stage's tolerance, by a linear constraint, and the solution is used as the
+// hint for the next stage. Every stage runs inside the same NIF call.
+
+extern "C"
+{
+  static ERL_NIF_TERM atom_minimize;
+  static ERL_NIF_TERM atom_maximize;
+
+  typedef struct
+  {
+    bool maximize;
+    LinearExpr *expr;
+    int64_t tolerance;
+  } Objective;
+
+  static int init_atoms(ErlNifEnv *env)
+  {
+    atom_minimize = enif_make_atom(env, "minimize");
+    atom_maximize = enif_make_atom(env, "maximize");
+    return 0;
+  }
+
+  // Decode `[{:minimize | :maximize, expr, tolerance}]`.
+  static int get_objectives(ErlNifEnv *env, ERL_NIF_TERM term, vector<Objective> *objectives)
+  {
+    ERL_NIF_TERM head;
+    ERL_NIF_TERM tail;
+    ERL_NIF_TERM current = term;
+    while (enif_get_list_cell(env, current, &head, &tail))
+    {
+      const ERL_NIF_TERM *elements;
+      int arity;
+      LinearExprWrapper *expr;
+      Objective objective;
+
+      if (!enif_get_tuple(env, head, &arity, &elements) || arity != 3)
+      {
+        return 0;
+      }
+
+      if (enif_is_identical(elements[0], atom_maximize))
+      {
+        objective.maximize = true;
+      }
+      else if (enif_is_identical(elements[0], atom_minimize))
+      {
+        objective.maximize = false;
+      }
+      else
+      {
+        return 0;
+      }
+
+      if (!decode(env, elements[1], &expr))
+      {
+        return 0;
+      }
+      objective.expr = expr->p;
+
+      if (!decode(env, elements[2], &objective.tolerance) || objective.tolerance < 0)
+      {
+        return 0;
+      }
+
+      objectives->push_back(objective);
+
+      current = tail;
+    }
+
+    return !objectives->empty();
+  }
+
+  // Constrain the objective of the solved stage to stay within its tolerance
+  // of `value`.
+  static void pin_objective(CpModelProto *model, const Objective &objective, int64_t value)
+  {
+    const LinearExpr &expr = *objective.expr;
+
+    ConstraintProto *constraint = model->add_constraints();
+    LinearConstraintProto *linear = constraint->mutable_linear();
+    for (size_t i = 0; i < expr.variables().size(); ++i)
+    {
+      linear->add_vars(expr.variables()[i]);
+      linear->add_coeffs(expr.coefficients()[i]);
+    }
+
+    int64_t lower_bound = objective.maximize ? value - objective.tolerance : INT64_MIN;
+    int64_t upper_bound = objective.maximize ? INT64_MAX : value + objective.tolerance;
+    linear->add_domain(objective.maximize ? lower_bound - expr.constant() : lower_bound);
+    linear->add_domain(objective.maximize ? upper_bound : upper_bound - expr.constant());
+  }
+
+  static void hint_solution(CpModelProto *model, const CpSolverResponse &response)
+  {
+    model->clear_solution_hint();
+    for (int i = 0; i < response.solution_size(); ++i)
+    {
+      model->mutable_solution_hint()->add_vars(i);
+      model->mutable_solution_hint()->add_values(response.solution(i));
+    }
+  }
+
+  ERL_NIF_TERM solve_lexicographic_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    vector<Objective> objectives;
+    SolveOptions options;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!get_objectives(env, argv[1], &objectives))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!get_solve_options(env, argv[2], &options))
+    {
+      return enif_make_badarg(env);
+    }
+
+    CpModelProto model = builder_wrapper->p->Build();
+    track_native_memory(BUILDER_MEMORY, &builder_wrapper->bytes, model.SpaceUsedLong());
+    CpSolverResponse response;
+    vector<ERL_NIF_TERM> values;
+    bool proven = true;
+
+    for (const Objective &objective : objectives)
+    {
+      set_objective(&model, *objective.expr, objective.maximize);
+
+      Model solver;
+      SatParameters parameters;
+      apply_solve_options(options, &parameters);
+      solver.Add(NewSatParameters(parameters));
+      unique_ptr<LogStream> log_stream = attach_log_stream(env, options, &solver);
+
+      CpSolverResponse stage_response = SolveCpModel(model, &solver);
+
+      // When a later stage finds no solution, the solution of the last solved
+      // stage is returned, as it is still feasible.
+      if (stage_response.status() != operations_research::sat::FEASIBLE &&
+          stage_response.status() != operations_research::sat::OPTIMAL)
+      {
+        if (values.empty())
+        {
+          response = stage_response;
+        }
+        else
+        {
+          proven = false;
+        }
+        break;
+      }
+
+      response = stage_response;
+
+      proven = proven && response.status() == operations_research::sat::OPTIMAL;
+
+      int64_t value = llround(response.objective_value());
+      values.push_back(enif_make_int64(env, value));
+      pin_objective(&model, objective, value);
+      hint_solution(&model, response);
+    }
+
+    // The last stage is only optimal if every stage before it was.
+    if (!proven && response.status() == operations_research::sat::OPTIMAL)
+    {
+      response.set_status(operations_research::sat::FEASIBLE);
+    }
+
+    ERL_NIF_TERM result = make_cp_solver_response(env, response);
+    result = put_map_value(env, result, "objectives", enif_make_list_from_array(env, values.data(), values.size()));
+
+    return result;
+  }
+
+  int load_lexicographic(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
+  {
+    if (init_atoms(env) == -1)
+      return -1;
+    else
+      return 0;
+  }
+}
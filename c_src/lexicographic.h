@@ -0,0 +1,13 @@
+#ifndef __LEXICOGRAPHIC_H__
+#define __LEXICOGRAPHIC_H__
+
+#include "erl_nif.h"
+
+extern "C"
+{
+  int load_lexicographic(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
+
+  ERL_NIF_TERM solve_lexicographic_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+}
+
+#endif
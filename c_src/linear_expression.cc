@@ -4,7 +4,9 @@
 #include "wrappers.h"
 #include "bool_var.h"
 #include "int_var.h"
+#include "native_memory.h"
 #include "utility.h"
+#include "decode.h"
 
 using operations_research::Domain;
 using operations_research::sat::LinearExpr;
@@ -15,9 +17,16 @@ extern "C"
 {
   ErlNifResourceType *LINEAR_EXPR_WRAPPER;
 
+  // The heap held by an expression, which does not change once created.
+  static size_t linear_expr_bytes(const LinearExpr &expr)
+  {
+    return sizeof(LinearExpr) + expr.variables().capacity() * sizeof(int) + expr.coefficients().capacity() * sizeof(int64_t);
+  }
+
   static void free_linear_expr(ErlNifEnv *env, void *obj)
   {
     LinearExprWrapper *w = (LinearExprWrapper *)obj;
+    release_native_resource(EXPRESSION_RESOURCE, linear_expr_bytes(*w->p));
     delete w->p;
   }
 
@@ -37,7 +46,7 @@ extern "C"
   {
     IntVarWrapper *var1;
 
-    if (!get_int_var(env, argv[0], &var1))
+    if (!decode(env, argv[0], &var1))
     {
       return enif_make_badarg(env);
     }
@@ -47,6 +56,7 @@ extern "C"
       return enif_make_badarg(env);
 
     linear_expr_wrapper->p = new LinearExpr(*var1->p);
+    count_native_resource(EXPRESSION_RESOURCE, linear_expr_bytes(*linear_expr_wrapper->p));
     ERL_NIF_TERM term = enif_make_resource(env, linear_expr_wrapper);
     enif_release_resource(linear_expr_wrapper);
 
@@ -57,7 +67,7 @@ extern "C"
   {
     BoolVarWrapper *var1;
 
-    if (!get_bool_var(env, argv[0], &var1))
+    if (!decode(env, argv[0], &var1))
     {
       return enif_make_badarg(env);
     }
@@ -67,6 +77,7 @@ extern "C"
       return enif_make_badarg(env);
 
     linear_expr_wrapper->p = new LinearExpr(*var1->p);
+    count_native_resource(EXPRESSION_RESOURCE, linear_expr_bytes(*linear_expr_wrapper->p));
     ERL_NIF_TERM term = enif_make_resource(env, linear_expr_wrapper);
     enif_release_resource(linear_expr_wrapper);
 
@@ -75,9 +86,9 @@ extern "C"
 
   ERL_NIF_TERM expr_from_constant_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
-    long var1;
+    int64_t var1;
 
-    if (!enif_get_int64(env, argv[0], &var1))
+    if (!decode(env, argv[0], &var1))
     {
       return enif_make_badarg(env);
     }
@@ -87,6 +98,7 @@ extern "C"
       return enif_make_badarg(env);
 
     linear_expr_wrapper->p = new LinearExpr(var1);
+    count_native_resource(EXPRESSION_RESOURCE, linear_expr_bytes(*linear_expr_wrapper->p));
     ERL_NIF_TERM term = enif_make_resource(env, linear_expr_wrapper);
     enif_release_resource(linear_expr_wrapper);
 
@@ -107,7 +119,7 @@ extern "C"
     for (int i = 0; i < arity; i++)
     {
       LinearExprWrapper *expr;
-      if (!get_linear_expression(env, vars[i], &expr))
+      if (!decode(env, vars[i], &expr))
       {
         return enif_make_badarg(env);
       }
@@ -120,6 +132,7 @@ extern "C"
       return enif_make_badarg(env);
 
     result->p = new LinearExpr(linear_expr);
+    count_native_resource(EXPRESSION_RESOURCE, linear_expr_bytes(*result->p));
     ERL_NIF_TERM term = enif_make_resource(env, result);
     enif_release_resource(result);
 
@@ -131,12 +144,12 @@ extern "C"
     LinearExprWrapper *expr1;
     LinearExprWrapper *expr2;
 
-    if (!get_linear_expression(env, argv[0], &expr1))
+    if (!decode(env, argv[0], &expr1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!get_linear_expression(env, argv[1], &expr2))
+    if (!decode(env, argv[1], &expr2))
     {
       return enif_make_badarg(env);
     }
@@ -146,6 +159,7 @@ extern "C"
       return enif_make_badarg(env);
 
     linear_expr_wrapper->p = new LinearExpr(*expr1->p - *expr2->p);
+    count_native_resource(EXPRESSION_RESOURCE, linear_expr_bytes(*linear_expr_wrapper->p));
     ERL_NIF_TERM term = enif_make_resource(env, linear_expr_wrapper);
     enif_release_resource(linear_expr_wrapper);
 
@@ -155,15 +169,15 @@ extern "C"
   ERL_NIF_TERM prod_expr1_constant2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     LinearExprWrapper *var1;
-    int int2;
+    int64_t int2;
     ERL_NIF_TERM term;
 
-    if (!get_linear_expression(env, argv[0], &var1))
+    if (!decode(env, argv[0], &var1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!enif_get_int(env, argv[1], &int2))
+    if (!decode(env, argv[1], &int2))
     {
       return enif_make_badarg(env);
     }
@@ -176,6 +190,7 @@ extern "C"
     result *= int2;
 
     linear_expr_wrapper->p = new LinearExpr(result);
+    count_native_resource(EXPRESSION_RESOURCE, linear_expr_bytes(*linear_expr_wrapper->p));
     term = enif_make_resource(env, linear_expr_wrapper);
     enif_release_resource(linear_expr_wrapper);
 
@@ -185,15 +200,15 @@ extern "C"
   ERL_NIF_TERM prod_bool_var1_constant2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     BoolVarWrapper *var1;
-    int int2;
+    int64_t int2;
     ERL_NIF_TERM term;
 
-    if (!get_bool_var(env, argv[0], &var1))
+    if (!decode(env, argv[0], &var1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!enif_get_int(env, argv[1], &int2))
+    if (!decode(env, argv[1], &int2))
     {
       return enif_make_badarg(env);
     }
@@ -203,6 +218,7 @@ extern "C"
       return enif_make_badarg(env);
 
     linear_expr_wrapper->p = new LinearExpr(LinearExpr::WeightedSum({*var1->p}, {int2}));
+    count_native_resource(EXPRESSION_RESOURCE, linear_expr_bytes(*linear_expr_wrapper->p));
     term = enif_make_resource(env, linear_expr_wrapper);
     enif_release_resource(linear_expr_wrapper);
 
@@ -212,15 +228,15 @@ extern "C"
   ERL_NIF_TERM prod_int_var1_constant2_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
   {
     IntVarWrapper *var1;
-    int int2;
+    int64_t int2;
     ERL_NIF_TERM term;
 
-    if (!get_int_var(env, argv[0], &var1))
+    if (!decode(env, argv[0], &var1))
     {
       return enif_make_badarg(env);
     }
 
-    if (!enif_get_int(env, argv[1], &int2))
+    if (!decode(env, argv[1], &int2))
     {
       return enif_make_badarg(env);
     }
@@ -230,6 +246,7 @@ extern "C"
       return enif_make_badarg(env);
 
     linear_expr_wrapper->p = new LinearExpr(LinearExpr::WeightedSum({*var1->p}, {int2}));
+    count_native_resource(EXPRESSION_RESOURCE, linear_expr_bytes(*linear_expr_wrapper->p));
     term = enif_make_resource(env, linear_expr_wrapper);
     enif_release_resource(linear_expr_wrapper);
 
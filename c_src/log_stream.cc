@@ -0,0 +1,109 @@
+#include <cstring>
+#include "erl_nif.h"
+#include "ortools/sat/model.h"
+#include "ortools/util/logging.h"
+#include "log_stream.h"
+
+using operations_research::SolverLogger;
+using operations_research::sat::Model;
+
+using namespace std;
+
+LogStream::LogStream(ErlNifEnv *caller_env, const SolveOptions &options)
+    : caller_env_(caller_env),
+      caller_thread_(this_thread::get_id()),
+      pid_(options.log_pid),
+      max_lines_(options.log_max_lines > 0 ? options.log_max_lines : 1),
+      max_bytes_(options.log_max_bytes > 0 ? options.log_max_bytes : 1),
+      flush_interval_(options.log_flush_interval),
+      msg_env_(enif_alloc_env()),
+      bytes_(0),
+      receiver_alive_(true)
+{
+  lines_.reserve(max_lines_);
+}
+
+LogStream::~LogStream()
+{
+  Flush();
+  enif_free_env(msg_env_);
+}
+
+void LogStream::Append(const string &line)
+{
+  lock_guard<mutex> lock(mutex_);
+
+  if (!receiver_alive_)
+  {
+    return;
+  }
+
+  size_t size = line.size();
+  while (size > 0 && line[size - 1] == '\n')
+  {
+    --size;
+  }
+  if (size > max_bytes_)
+  {
+    size = max_bytes_;
+  }
+
+  if (lines_.empty())
+  {
+    first_line_at_ = chrono::steady_clock::now();
+  }
+
+  ERL_NIF_TERM term;
+  unsigned char *data = enif_make_new_binary(msg_env_, size, &term);
+  memcpy(data, line.data(), size);
+  lines_.push_back(term);
+  bytes_ += size;
+
+  if (lines_.size() >= max_lines_ ||
+      bytes_ >= max_bytes_ ||
+      chrono::steady_clock::now() - first_line_at_ >= flush_interval_)
+  {
+    FlushLocked();
+  }
+}
+
+void LogStream::Flush()
+{
+  lock_guard<mutex> lock(mutex_);
+  FlushLocked();
+}
+
+void LogStream::FlushLocked()
+{
+  if (lines_.empty())
+  {
+    return;
+  }
+
+  ERL_NIF_TERM list = enif_make_list_from_array(msg_env_, lines_.data(), lines_.size());
+  ERL_NIF_TERM msg = enif_make_tuple2(msg_env_, enif_make_atom(msg_env_, "exhort_log"), list);
+
+  // CP-SAT logs from its own worker threads as well as from the thread that
+  // called the NIF. Only the latter may pass the caller's environment.
+  ErlNifEnv *env = this_thread::get_id() == caller_thread_ ? caller_env_ : NULL;
+  receiver_alive_ = enif_send(env, &pid_, msg_env_, msg);
+
+  enif_clear_env(msg_env_);
+  lines_.clear();
+  bytes_ = 0;
+}
+
+unique_ptr<LogStream> attach_log_stream(ErlNifEnv *env, const SolveOptions &options, Model *model)
+{
+  if (!options.has_log_pid)
+  {
+    return nullptr;
+  }
+
+  unique_ptr<LogStream> stream(new LogStream(env, options));
+  LogStream *s = stream.get();
+  model->GetOrCreate<SolverLogger>()->AddInfoLoggingCallback([s](const string &line)
+                                                             { s->Append(line); });
+
+  return stream;
+}
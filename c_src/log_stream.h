@@ -0,0 +1,55 @@
+#ifndef __LOG_STREAM_H__
+#define __LOG_STREAM_H__
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "erl_nif.h"
+#include "ortools/sat/model.h"
+#include "solve_options.h"
+
+using operations_research::sat::Model;
+
+// Forward solver log lines to a process as `{:exhort_log, [line]}` messages.
+//
+// Lines are copied into a dedicated message environment and sent in batches,
+// so the solver threads never build terms in the calling process's
+// environment. A batch is sent once it holds `log_max_lines` lines or
+// `log_max_bytes` bytes, or once its oldest line has waited
+// `log_flush_interval` milliseconds. Once the receiver has exited, further
+// lines are discarded without being copied.
+class LogStream
+{
+public:
+  LogStream(ErlNifEnv *caller_env, const SolveOptions &options);
+  ~LogStream();
+
+  void Append(const std::string &line);
+  void Flush();
+
+private:
+  void FlushLocked();
+
+  ErlNifEnv *caller_env_;
+  std::thread::id caller_thread_;
+  ErlNifPid pid_;
+  size_t max_lines_;
+  size_t max_bytes_;
+  std::chrono::milliseconds flush_interval_;
+
+  std::mutex mutex_;
+  ErlNifEnv *msg_env_;
+  std::vector<ERL_NIF_TERM> lines_;
+  size_t bytes_;
+  bool receiver_alive_;
+  std::chrono::steady_clock::time_point first_line_at_;
+};
+
+// Route the search log of `model` to the log process in `options`, if any. The
+// returned stream must outlive the solve.
+std::unique_ptr<LogStream> attach_log_stream(ErlNifEnv *env, const SolveOptions &options, Model *model);
+
+#endif
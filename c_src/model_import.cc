@@ -0,0 +1,220 @@
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "bool_var.h"
+#include "cp_model_builder.h"
+#include "int_var.h"
+#include "model_import.h"
+#include "core/model_import.h"
+
+using operations_research::sat::BoolVar;
+using operations_research::sat::CpModelBuilder;
+using operations_research::sat::IntVar;
+
+using namespace std;
+
+// Read OPB and MPS instances into a new builder natively, instead of through
+// the DSL.
+
+extern "C"
+{
+  static ERL_NIF_TERM atom_opb;
+  static ERL_NIF_TERM atom_mps;
+  static ERL_NIF_TERM atom_path;
+
+  int load_model_import(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
+  {
+    atom_opb = enif_make_atom(env, "opb");
+    atom_mps = enif_make_atom(env, "mps");
+    atom_path = enif_make_atom(env, "path");
+    return 0;
+  }
+
+  static ERL_NIF_TERM make_error(ErlNifEnv *env, int error)
+  {
+    const char *reason;
+    switch (error)
+    {
+    case ENOENT:
+      reason = "enoent";
+      break;
+    case EACCES:
+      reason = "eacces";
+      break;
+    case EISDIR:
+      reason = "eisdir";
+      break;
+    default:
+      reason = "eio";
+    }
+
+    return enif_make_tuple2(env, enif_make_atom(env, "error"), enif_make_atom(env, reason));
+  }
+
+  static ERL_NIF_TERM make_parse_error(ErlNifEnv *env, const ImportError &error)
+  {
+    ErlNifBinary message;
+    enif_alloc_binary(error.message.size(), &message);
+    memcpy(message.data, error.message.data(), error.message.size());
+
+    return enif_make_tuple2(env,
+                            enif_make_atom(env, "error"),
+                            enif_make_tuple3(env,
+                                             enif_make_atom(env, "parse"),
+                                             enif_make_uint64(env, error.line),
+                                             enif_make_binary(env, &message)));
+  }
+
+  // Map `{:path, path}` into memory, or take the contents of a binary.
+  static int get_source(ErlNifEnv *env, ERL_NIF_TERM term, const char **data, size_t *size, bool *mapped, int *error)
+  {
+    ErlNifBinary binary;
+    int arity;
+    const ERL_NIF_TERM *elements;
+
+    *mapped = false;
+    *error = 0;
+
+    if (enif_inspect_binary(env, term, &binary))
+    {
+      *data = (const char *)binary.data;
+      *size = binary.size;
+      return 1;
+    }
+
+    if (!enif_get_tuple(env, term, &arity, &elements) || arity != 2 ||
+        !enif_is_identical(elements[0], atom_path) ||
+        !enif_inspect_binary(env, elements[1], &binary))
+    {
+      return 0;
+    }
+
+    string path((const char *)binary.data, binary.size);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      *error = errno;
+      return 1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+      *error = errno;
+      close(fd);
+      return 1;
+    }
+
+    if (S_ISDIR(st.st_mode))
+    {
+      *error = EISDIR;
+      close(fd);
+      return 1;
+    }
+
+    *data = "";
+    *size = st.st_size;
+    if (*size > 0)
+    {
+      void *p = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED)
+      {
+        *error = errno;
+        close(fd);
+        return 1;
+      }
+
+      // The file is read once, front to back.
+      madvise(p, *size, MADV_SEQUENTIAL);
+      *data = (const char *)p;
+      *mapped = true;
+    }
+
+    close(fd);
+    return 1;
+  }
+
+  // import_model_nif(format, source) reads an `:opb` or `:mps` instance from
+  // `source`, a binary of its contents or `{:path, path}`, into a new builder.
+  // Returns `{:ok, builder, %{name => var}}`, where the variables are boolean
+  // for OPB and integer for MPS, `{:error, {:parse, line, message}}` or
+  // `{:error, reason}` when the file can't be read.
+  ERL_NIF_TERM import_model_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    bool opb = enif_is_identical(argv[0], atom_opb);
+    if (!opb && !enif_is_identical(argv[0], atom_mps))
+    {
+      return enif_make_badarg(env);
+    }
+
+    const char *data;
+    size_t size;
+    bool mapped;
+    int error;
+    if (!get_source(env, argv[1], &data, &size, &mapped, &error))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (error != 0)
+    {
+      return make_error(env, error);
+    }
+
+    CpModelBuilder *builder = new CpModelBuilder();
+    vector<string> names;
+    ImportError import_error;
+    bool imported = opb ? import_opb(data, size, builder, &names, &import_error)
+                        : import_mps(data, size, builder, &names, &import_error);
+
+    if (mapped)
+    {
+      munmap((void *)data, size);
+    }
+
+    if (!imported)
+    {
+      delete builder;
+      return make_parse_error(env, import_error);
+    }
+
+    vector<ERL_NIF_TERM> keys;
+    vector<ERL_NIF_TERM> values;
+    keys.reserve(names.size());
+    values.reserve(names.size());
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+      ErlNifBinary name;
+      enif_alloc_binary(names[i].size(), &name);
+      memcpy(name.data, names[i].data(), names[i].size());
+      keys.push_back(enif_make_binary(env, &name));
+
+      if (opb)
+      {
+        BoolVar var = builder->GetBoolVarFromProtoIndex(i);
+        values.push_back(make_bool_var(env, var));
+      }
+      else
+      {
+        IntVar var = builder->GetIntVarFromProtoIndex(i);
+        values.push_back(make_int_var(env, var));
+      }
+    }
+
+    ERL_NIF_TERM vars;
+    if (!enif_make_map_from_arrays(env, keys.data(), values.data(), keys.size(), &vars))
+    {
+      delete builder;
+      return make_parse_error(env, ImportError{0, "duplicate variable"});
+    }
+
+    return enif_make_tuple3(env, enif_make_atom(env, "ok"), make_cp_model_builder(env, builder), vars);
+  }
+}
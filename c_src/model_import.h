@@ -0,0 +1,13 @@
+#ifndef __MODEL_IMPORT_H__
+#define __MODEL_IMPORT_H__
+
+#include "erl_nif.h"
+
+extern "C"
+{
+  int load_model_import(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
+
+  ERL_NIF_TERM import_model_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+}
+
+#endif
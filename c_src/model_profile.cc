@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "wrappers.h"
+#include "cp_model_builder.h"
+#include "cp_solver_response.h"
+#include "model_profile.h"
+#include "native_memory.h"
+#include "utility.h"
+#include "decode.h"
+
+using operations_research::sat::ConstraintProto;
+using operations_research::sat::CpModelProto;
+using operations_research::sat::IntegerVariableProto;
+using operations_research::sat::LinearArgumentProto;
+
+using namespace std;
+
+// Report how a built model is formulated, to find the parts of it that make
+// it slow to solve: wide domains, long constraints and heavy use of
+// enforcement literals.
+
+extern "C"
+{
+  typedef struct
+  {
+    unsigned long count;
+    unsigned long terms;
+    unsigned long max_terms;
+    unsigned long enforced;
+  } ConstraintTypeProfile;
+
+  typedef struct
+  {
+    int index;
+    const char *type;
+    int terms;
+    int enforcement;
+  } ConstraintSize;
+
+  static const char *constraint_type(const ConstraintProto &constraint)
+  {
+    switch (constraint.constraint_case())
+    {
+    case ConstraintProto::kBoolOr:
+      return "bool_or";
+    case ConstraintProto::kBoolAnd:
+      return "bool_and";
+    case ConstraintProto::kAtMostOne:
+      return "at_most_one";
+    case ConstraintProto::kExactlyOne:
+      return "exactly_one";
+    case ConstraintProto::kBoolXor:
+      return "bool_xor";
+    case ConstraintProto::kIntDiv:
+      return "int_div";
+    case ConstraintProto::kIntMod:
+      return "int_mod";
+    case ConstraintProto::kIntProd:
+      return "int_prod";
+    case ConstraintProto::kLinMax:
+      return "lin_max";
+    case ConstraintProto::kLinear:
+      return "linear";
+    case ConstraintProto::kAllDiff:
+      return "all_diff";
+    case ConstraintProto::kElement:
+      return "element";
+    case ConstraintProto::kCircuit:
+      return "circuit";
+    case ConstraintProto::kRoutes:
+      return "routes";
+    case ConstraintProto::kTable:
+      return "table";
+    case ConstraintProto::kAutomaton:
+      return "automaton";
+    case ConstraintProto::kInverse:
+      return "inverse";
+    case ConstraintProto::kReservoir:
+      return "reservoir";
+    case ConstraintProto::kInterval:
+      return "interval";
+    case ConstraintProto::kNoOverlap:
+      return "no_overlap";
+    case ConstraintProto::kNoOverlap2D:
+      return "no_overlap_2d";
+    case ConstraintProto::kCumulative:
+      return "cumulative";
+    default:
+      return "empty";
+    }
+  }
+
+  static int linear_argument_terms(const LinearArgumentProto &argument)
+  {
+    int terms = argument.target().vars_size();
+    for (const auto &expr : argument.exprs())
+    {
+      terms += expr.vars_size();
+    }
+    return terms;
+  }
+
+  // The number of variable references of `constraint`. Constraints without a
+  // case below count as 0.
+  static int constraint_terms(const ConstraintProto &constraint)
+  {
+    switch (constraint.constraint_case())
+    {
+    case ConstraintProto::kBoolOr:
+      return constraint.bool_or().literals_size();
+    case ConstraintProto::kBoolAnd:
+      return constraint.bool_and().literals_size();
+    case ConstraintProto::kAtMostOne:
+      return constraint.at_most_one().literals_size();
+    case ConstraintProto::kExactlyOne:
+      return constraint.exactly_one().literals_size();
+    case ConstraintProto::kBoolXor:
+      return constraint.bool_xor().literals_size();
+    case ConstraintProto::kIntDiv:
+      return linear_argument_terms(constraint.int_div());
+    case ConstraintProto::kIntMod:
+      return linear_argument_terms(constraint.int_mod());
+    case ConstraintProto::kIntProd:
+      return linear_argument_terms(constraint.int_prod());
+    case ConstraintProto::kLinMax:
+      return linear_argument_terms(constraint.lin_max());
+    case ConstraintProto::kLinear:
+      return constraint.linear().vars_size();
+    case ConstraintProto::kAllDiff:
+    {
+      int terms = 0;
+      for (const auto &expr : constraint.all_diff().exprs())
+      {
+        terms += expr.vars_size();
+      }
+      return terms;
+    }
+    case ConstraintProto::kCircuit:
+      return constraint.circuit().literals_size();
+    case ConstraintProto::kRoutes:
+      return constraint.routes().literals_size();
+    case ConstraintProto::kTable:
+      return constraint.table().vars_size();
+    case ConstraintProto::kInterval:
+      return constraint.interval().start().vars_size() +
+             constraint.interval().size().vars_size() +
+             constraint.interval().end().vars_size();
+    case ConstraintProto::kNoOverlap:
+      return constraint.no_overlap().intervals_size();
+    case ConstraintProto::kCumulative:
+      return constraint.cumulative().intervals_size();
+    default:
+      return 0;
+    }
+  }
+
+  // Bucket a variable by the width of its domain.
+  static const char *domain_class(const IntegerVariableProto &var)
+  {
+    int size = var.domain_size();
+    if (size < 2)
+    {
+      return "empty";
+    }
+
+    int64_t lower_bound = var.domain(0);
+    int64_t upper_bound = var.domain(size - 1);
+
+    if (lower_bound == upper_bound)
+    {
+      return "fixed";
+    }
+
+    // The width is taken unsigned, as it overflows int64 for the widest
+    // domains.
+    uint64_t width = (uint64_t)upper_bound - (uint64_t)lower_bound;
+    if (lower_bound == INT64_MIN || upper_bound == INT64_MAX || width > ((uint64_t)1 << 32))
+    {
+      return "unbounded";
+    }
+
+    if (width == 1)
+    {
+      return "boolean";
+    }
+    else if (width <= 100)
+    {
+      return "small";
+    }
+    else if (width <= 1000000)
+    {
+      return "medium";
+    }
+
+    return "large";
+  }
+
+  static ERL_NIF_TERM make_counts(ErlNifEnv *env, const map<string, unsigned long> &counts)
+  {
+    ERL_NIF_TERM result = enif_make_new_map(env);
+    for (const auto &count : counts)
+    {
+      enif_make_map_put(env, result, make_binary_key(env, count.first.c_str()), enif_make_uint64(env, count.second), &result);
+    }
+    return result;
+  }
+
+  ERL_NIF_TERM profile_model_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    unsigned int top;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!enif_get_uint(env, argv[1], &top))
+    {
+      return enif_make_badarg(env);
+    }
+
+    const CpModelProto &model = builder_wrapper->p->Build();
+    track_native_memory(BUILDER_MEMORY, &builder_wrapper->bytes, model.SpaceUsedLong());
+
+    map<string, unsigned long> domains;
+    unsigned long domains_with_holes = 0;
+    for (const IntegerVariableProto &var : model.variables())
+    {
+      ++domains[domain_class(var)];
+      if (var.domain_size() > 2)
+      {
+        ++domains_with_holes;
+      }
+    }
+
+    map<string, ConstraintTypeProfile> types;
+    map<unsigned long, unsigned long> enforcement;
+    vector<ConstraintSize> sizes;
+    sizes.reserve(model.constraints_size());
+    for (int i = 0; i < model.constraints_size(); ++i)
+    {
+      const ConstraintProto &constraint = model.constraints(i);
+      const char *type = constraint_type(constraint);
+      int terms = constraint_terms(constraint);
+      int enforced = constraint.enforcement_literal_size();
+
+      ConstraintTypeProfile &profile = types[type];
+      ++profile.count;
+      profile.terms += terms;
+      profile.max_terms = max(profile.max_terms, (unsigned long)terms);
+      if (enforced > 0)
+      {
+        ++profile.enforced;
+      }
+
+      ++enforcement[enforced];
+      sizes.push_back({i, type, terms, enforced});
+    }
+
+    size_t largest = min((size_t)top, sizes.size());
+    partial_sort(sizes.begin(), sizes.begin() + largest, sizes.end(),
+                 [](const ConstraintSize &a, const ConstraintSize &b)
+                 { return a.terms > b.terms || (a.terms == b.terms && a.index < b.index); });
+
+    ERL_NIF_TERM constraints = enif_make_new_map(env);
+    for (const auto &type : types)
+    {
+      ERL_NIF_TERM profile = enif_make_new_map(env);
+      profile = put_map_value(env, profile, "count", enif_make_uint64(env, type.second.count));
+      profile = put_map_value(env, profile, "terms", enif_make_uint64(env, type.second.terms));
+      profile = put_map_value(env, profile, "max_terms", enif_make_uint64(env, type.second.max_terms));
+      profile = put_map_value(env, profile, "enforced", enif_make_uint64(env, type.second.enforced));
+      constraints = put_map_value(env, constraints, type.first.c_str(), profile);
+    }
+
+    ERL_NIF_TERM enforcement_histogram = enif_make_new_map(env);
+    for (const auto &count : enforcement)
+    {
+      enif_make_map_put(env, enforcement_histogram, enif_make_uint64(env, count.first), enif_make_uint64(env, count.second), &enforcement_histogram);
+    }
+
+    vector<ERL_NIF_TERM> largest_constraints;
+    for (size_t i = 0; i < largest; ++i)
+    {
+      ERL_NIF_TERM size = enif_make_new_map(env);
+      size = put_map_value(env, size, "index", enif_make_int(env, sizes[i].index));
+      size = put_map_value(env, size, "type", make_binary_key(env, sizes[i].type));
+      size = put_map_value(env, size, "terms", enif_make_int(env, sizes[i].terms));
+      size = put_map_value(env, size, "enforcement", enif_make_int(env, sizes[i].enforcement));
+      largest_constraints.push_back(size);
+    }
+
+    ERL_NIF_TERM result = enif_make_new_map(env);
+    result = put_map_value(env, result, "variables", enif_make_int(env, model.variables_size()));
+    result = put_map_value(env, result, "domains", make_counts(env, domains));
+    result = put_map_value(env, result, "domains_with_holes", enif_make_uint64(env, domains_with_holes));
+    result = put_map_value(env, result, "constraints", constraints);
+    result = put_map_value(env, result, "enforcement", enforcement_histogram);
+    result = put_map_value(env, result, "objective_terms", enif_make_int(env, model.objective().vars_size()));
+    result = put_map_value(env, result, "decision_strategies", enif_make_int(env, model.search_strategy_size()));
+    result = put_map_value(env, result, "memory", enif_make_uint64(env, model.SpaceUsedLong()));
+    result = put_map_value(env, result, "serialized_size", enif_make_uint64(env, model.ByteSizeLong()));
+    result = put_map_value(env, result, "largest_constraints", enif_make_list_from_array(env, largest_constraints.data(), largest_constraints.size()));
+
+    return result;
+  }
+
+  int load_model_profile(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
+  {
+    return 0;
+  }
+}
@@ -0,0 +1,13 @@
+#ifndef __MODEL_PROFILE_H__
+#define __MODEL_PROFILE_H__
+
+#include "erl_nif.h"
+
+extern "C"
+{
+  int load_model_profile(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
+
+  ERL_NIF_TERM profile_model_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include <atomic>
+#include <cstdio>
+#include "erl_nif.h"
+#include "cp_solver_response.h"
+#include "native_memory.h"
+#include "utility.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+using namespace std;
+
+extern "C"
+{
+  static atomic<long long> tracked_bytes[NATIVE_MEMORY_KINDS];
+
+  static atomic<long long> live_resources[NATIVE_RESOURCE_KINDS];
+  static atomic<long long> allocated_resources[NATIVE_RESOURCE_KINDS];
+  static atomic<long long> resource_bytes[NATIVE_RESOURCE_KINDS];
+
+  static const char *resource_names[NATIVE_RESOURCE_KINDS] = {
+      "builders",
+      "bool_vars",
+      "int_vars",
+      "interval_vars",
+      "expressions",
+      "constraints",
+      "responses",
+      "presolved",
+      "solution_files"};
+
+  // The memory tracked for the models some resources hold, beyond the size
+  // counted when they were allocated.
+  static long long model_bytes(NativeResourceKind kind)
+  {
+    switch (kind)
+    {
+    case BUILDER_RESOURCE:
+      return tracked_bytes[BUILDER_MEMORY];
+    case RESPONSE_RESOURCE:
+      return tracked_bytes[RESPONSE_MEMORY];
+    case PRESOLVED_RESOURCE:
+      return tracked_bytes[PRESOLVED_MEMORY];
+    default:
+      return 0;
+    }
+  }
+
+  void count_native_resource(NativeResourceKind kind, size_t bytes)
+  {
+    ++live_resources[kind];
+    ++allocated_resources[kind];
+    resource_bytes[kind] += (long long)bytes;
+  }
+
+#ifdef EXHORT_DEBUG_RESOURCES
+  static void report_live_resources()
+  {
+    enif_fprintf(stderr, "exhort: builder freed, live native resources:");
+    for (int kind = 0; kind < NATIVE_RESOURCE_KINDS; ++kind)
+    {
+      enif_fprintf(stderr, " %s=%lld (%lld bytes)", resource_names[kind], (long long)live_resources[kind], (long long)resource_bytes[kind] + model_bytes((NativeResourceKind)kind));
+    }
+    enif_fprintf(stderr, "\n");
+  }
+#endif
+
+  void release_native_resource(NativeResourceKind kind, size_t bytes)
+  {
+    --live_resources[kind];
+    resource_bytes[kind] -= (long long)bytes;
+
+#ifdef EXHORT_DEBUG_RESOURCES
+    if (kind == BUILDER_RESOURCE)
+    {
+      report_live_resources();
+    }
+#endif
+  }
+
+  void track_native_memory(NativeMemoryKind kind, std::atomic<size_t> *tracked, size_t bytes)
+  {
+    size_t previous = tracked->exchange(bytes);
+    tracked_bytes[kind] += (long long)bytes - (long long)previous;
+  }
+
+  size_t process_resident_bytes()
+  {
+#if defined(__linux__)
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == NULL)
+    {
+      return 0;
+    }
+
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    int read = fscanf(statm, "%lu %lu", &size, &resident);
+    fclose(statm);
+
+    return read == 2 ? resident * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+    {
+      return 0;
+    }
+
+    return info.resident_size;
+#else
+    return 0;
+#endif
+  }
+
+  ERL_NIF_TERM native_memory_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    ERL_NIF_TERM result = enif_make_new_map(env);
+    result = put_map_value(env, result, "builders", enif_make_int64(env, tracked_bytes[BUILDER_MEMORY]));
+    result = put_map_value(env, result, "responses", enif_make_int64(env, tracked_bytes[RESPONSE_MEMORY]));
+    result = put_map_value(env, result, "presolved", enif_make_int64(env, tracked_bytes[PRESOLVED_MEMORY]));
+    result = put_map_value(env, result, "rss", enif_make_uint64(env, process_resident_bytes()));
+
+    return result;
+  }
+
+  // native_resources_nif() returns, for each kind of resource,
+  // `%{"live" => _, "allocated" => _, "bytes" => _}` where `allocated` counts
+  // every resource allocated since the library was loaded.
+  ERL_NIF_TERM native_resources_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    ERL_NIF_TERM result = enif_make_new_map(env);
+    for (int kind = 0; kind < NATIVE_RESOURCE_KINDS; ++kind)
+    {
+      ERL_NIF_TERM counters = enif_make_new_map(env);
+      counters = put_map_value(env, counters, "live", enif_make_int64(env, live_resources[kind]));
+      counters = put_map_value(env, counters, "allocated", enif_make_int64(env, allocated_resources[kind]));
+      counters = put_map_value(env, counters, "bytes", enif_make_int64(env, resource_bytes[kind] + model_bytes((NativeResourceKind)kind)));
+      result = put_map_value(env, result, resource_names[kind], counters);
+    }
+
+    return result;
+  }
+
+  int load_native_memory(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
+  {
+    return 0;
+  }
+}
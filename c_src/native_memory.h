@@ -0,0 +1,58 @@
+#ifndef __NATIVE_MEMORY_H__
+#define __NATIVE_MEMORY_H__
+
+#include <atomic>
+#include <cstddef>
+#include "erl_nif.h"
+
+extern "C"
+{
+  // The kinds of native objects whose memory is accounted for.
+  typedef enum
+  {
+    BUILDER_MEMORY,
+    RESPONSE_MEMORY,
+    PRESOLVED_MEMORY,
+    NATIVE_MEMORY_KINDS
+  } NativeMemoryKind;
+
+  // The kinds of NIF resources whose live objects are counted.
+  typedef enum
+  {
+    BUILDER_RESOURCE,
+    BOOL_VAR_RESOURCE,
+    INT_VAR_RESOURCE,
+    INTERVAL_VAR_RESOURCE,
+    EXPRESSION_RESOURCE,
+    CONSTRAINT_RESOURCE,
+    RESPONSE_RESOURCE,
+    PRESOLVED_RESOURCE,
+    SOLUTION_FILE_RESOURCE,
+    NATIVE_RESOURCE_KINDS
+  } NativeResourceKind;
+
+  int load_native_memory(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
+
+  // Record that a resource of `kind` holding `bytes` was allocated.
+  void count_native_resource(NativeResourceKind kind, size_t bytes);
+
+  // Record that a resource of `kind` holding `bytes` was freed. Built with
+  // `EXHORT_DEBUG_RESOURCES`, the resources still live are written to stderr
+  // whenever a builder is freed.
+  void release_native_resource(NativeResourceKind kind, size_t bytes);
+
+  // Record that an object of `kind` now holds `bytes`. `tracked` is the size
+  // last recorded for the object, kept in its wrapper, and is updated. It is
+  // atomic as concurrent solves of the same builder update it. Call with zero
+  // bytes when the object is freed.
+  void track_native_memory(NativeMemoryKind kind, std::atomic<size_t> *tracked, size_t bytes);
+
+  // The resident set size of the whole process, or 0 where it is not known.
+  size_t process_resident_bytes();
+
+  ERL_NIF_TERM native_memory_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM native_resources_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+}
+
+#endif
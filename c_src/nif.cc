@@ -8,6 +8,18 @@
 #include "int_var.h"
 #include "interval_var.h"
 #include "cp_solver_response.h"
+#include "improve.h"
+#include "lexicographic.h"
+#include "model_import.h"
+#include "model_profile.h"
+#include "native_memory.h"
+#include "presolve.h"
+#include "probes.h"
+#include "remote_solve.h"
+#include "scheduling.h"
+#include "solution_file.h"
+#include "solution_pool.h"
+#include "solve_options.h"
 
 extern "C"
 {
@@ -19,51 +31,102 @@ extern "C"
     load_int_var(env, priv, load_info);
     load_interval_var(env, priv, load_info);
     load_cp_solver_response(env, priv, load_info);
+    load_solve_options(env, priv, load_info);
+    load_improve(env, priv, load_info);
+    load_lexicographic(env, priv, load_info);
+    load_model_import(env, priv, load_info);
+    load_model_profile(env, priv, load_info);
+    load_native_memory(env, priv, load_info);
+    load_presolve(env, priv, load_info);
+    load_remote_solve(env, priv, load_info);
+    load_solution_file(env, priv, load_info);
+    load_solution_pool(env, priv, load_info);
 
     return 0;
   }
 
   static ErlNifFunc nif_funcs[] = {
-      {"add_abs_equal_nif", 3, add_abs_equal_nif},
-      {"add_bool_and_nif", 2, add_bool_and_nif},
-      {"add_bool_or_nif", 2, add_bool_or_nif},
-      {"add_abs_equal_constant_nif", 3, add_abs_equal_constant_nif},
-      {"add_all_different_nif", 2, add_all_different_nif},
-      {"add_decision_strategy_nif", 4, add_decision_strategy_nif},
-      {"add_no_overlap_nif", 2, add_no_overlap_nif},
-      {"add_implication_nif", 3, add_implication_nif},
-      {"add_equal_expr1_expr2_nif", 3, add_equal_expr1_expr2_nif},
-      {"add_equal_expr1_constant2_nif", 3, add_equal_expr1_constant2_nif},
-      {"add_equal_int_nif", 3, add_equal_int_nif},
-      {"add_greater_or_equal_expr1_expr2_nif", 3, add_greater_or_equal_expr1_expr2_nif},
-      {"add_greater_than_expr1_expr2_nif", 3, add_greater_than_expr1_expr2_nif},
-      {"add_max_equality_nif", 3, add_max_equality_nif},
-      {"add_minimize_nif", 2, add_minimize_nif},
-      {"add_maximize_nif", 2, add_maximize_nif},
-      {"add_less_than_expr1_expr2_nif", 3, add_less_than_expr1_expr2_nif},
-      {"add_less_or_equal_expr1_expr2_nif", 3, add_less_or_equal_expr1_expr2_nif},
-      {"add_not_equal_expr1_expr2_nif", 3, add_not_equal_expr1_expr2_nif},
-      {"add_not_equal_bool_nif", 3, add_not_equal_bool_nif},
-      {"bool_not_nif", 1, bool_not_nif},
-      {"new_bool_var_nif", 2, new_bool_var_nif},
-      {"new_builder_nif", 0, new_builder_nif},
-      {"new_int_var_nif", 4, new_int_var_nif},
-      {"new_constant_nif", 3, new_constant_nif},
-      {"new_interval_var_nif", 5, new_interval_var_nif},
-      {"new_optional_interval_var_nif", 6, new_optional_interval_var_nif},
-      {"only_enforce_if_nif", 2, only_enforce_if_nif},
-      {"solution_bool_value_nif", 2, solution_bool_value_nif},
-      {"solution_integer_value_nif", 2, solution_integer_value_nif},
-      {"solve_nif", 1, solve_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
-      {"solve_with_callback_nif", 2, solve_with_callback_nif, ERL_NIF_DIRTY_JOB_CPU_BOUND},
-      {"prod_expr1_constant2_nif", 2, prod_expr1_constant2_nif},
-      {"prod_bool_var1_constant2_nif", 2, prod_bool_var1_constant2_nif},
-      {"prod_int_var1_constant2_nif", 2, prod_int_var1_constant2_nif},
-      {"sum_nif", 1, sum_nif},
-      {"minus_nif", 2, minus_nif},
-      {"expr_from_int_var_nif", 1, expr_from_int_var_nif},
-      {"expr_from_bool_var_nif", 1, expr_from_bool_var_nif},
-      {"expr_from_constant_nif", 1, expr_from_constant_nif}};
+      {"add_abs_equal_nif", 3, probed_nif<add_abs_equal_nif>},
+      {"add_bool_and_nif", 2, probed_nif<sized_nif<add_bool_and_nif, 1>>},
+      {"add_bool_or_nif", 2, probed_nif<sized_nif<add_bool_or_nif, 1>>},
+      {"add_abs_equal_constant_nif", 3, probed_nif<add_abs_equal_constant_nif>},
+      {"add_all_different_nif", 2, probed_nif<sized_nif<add_all_different_nif, 1>>},
+      {"add_decision_strategy_nif", 4, probed_nif<sized_nif<add_decision_strategy_nif, 1>>},
+      {"add_no_overlap_nif", 2, probed_nif<sized_nif<add_no_overlap_nif, 1>>},
+      {"add_cumulative_nif", 4, probed_nif<sized_nif<add_cumulative_nif, 2>>},
+      {"add_cumulative_demands_nif", 4, probed_nif<sized_nif<add_cumulative_demands_nif, 2>>},
+      {"add_allowed_assignments_nif", 3, probed_nif<sized_nif<add_allowed_assignments_nif, 2, sizeof(int64_t)>>},
+      {"add_forbidden_assignments_nif", 3, probed_nif<sized_nif<add_forbidden_assignments_nif, 2, sizeof(int64_t)>>},
+      {"add_circuit_nif", 2, probed_nif<sized_nif<add_circuit_nif, 1>>},
+      {"add_multiple_circuit_nif", 2, probed_nif<sized_nif<add_multiple_circuit_nif, 1>>},
+      {"add_implication_nif", 3, probed_nif<add_implication_nif>},
+      {"add_equal_expr1_expr2_nif", 3, probed_nif<add_equal_expr1_expr2_nif>},
+      {"add_equal_expr1_constant2_nif", 3, probed_nif<add_equal_expr1_constant2_nif>},
+      {"add_equal_int_nif", 3, probed_nif<add_equal_int_nif>},
+      {"add_greater_or_equal_expr1_expr2_nif", 3, probed_nif<add_greater_or_equal_expr1_expr2_nif>},
+      {"add_greater_than_expr1_expr2_nif", 3, probed_nif<add_greater_than_expr1_expr2_nif>},
+      {"add_max_equality_nif", 3, probed_nif<sized_nif<add_max_equality_nif, 2>>},
+      {"add_minimize_nif", 2, probed_nif<add_minimize_nif>},
+      {"add_maximize_nif", 2, probed_nif<add_maximize_nif>},
+      {"add_less_than_expr1_expr2_nif", 3, probed_nif<add_less_than_expr1_expr2_nif>},
+      {"add_less_or_equal_expr1_expr2_nif", 3, probed_nif<add_less_or_equal_expr1_expr2_nif>},
+      {"add_not_equal_expr1_expr2_nif", 3, probed_nif<add_not_equal_expr1_expr2_nif>},
+      {"add_not_equal_bool_nif", 3, probed_nif<add_not_equal_bool_nif>},
+      {"bool_not_nif", 1, probed_nif<bool_not_nif>},
+      {"new_bool_var_nif", 2, probed_nif<new_bool_var_nif>},
+      {"new_builder_nif", 0, probed_nif<new_builder_nif>},
+      {"new_sub_builder_nif", 1, probed_nif<new_sub_builder_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"merge_builders_nif", 2, probed_nif<merge_builders_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"new_int_var_nif", 4, probed_nif<new_int_var_nif>},
+      {"new_constant_nif", 3, probed_nif<new_constant_nif>},
+      {"new_interval_var_nif", 5, probed_nif<new_interval_var_nif>},
+      {"new_optional_interval_var_nif", 6, probed_nif<new_optional_interval_var_nif>},
+      {"new_fixed_size_interval_var_nif", 4, probed_nif<new_fixed_size_interval_var_nif>},
+      {"new_optional_fixed_size_interval_var_nif", 5, probed_nif<new_optional_fixed_size_interval_var_nif>},
+      {"native_memory_nif", 0, probed_nif<native_memory_nif>},
+      {"native_resources_nif", 0, probed_nif<native_resources_nif>},
+      {"only_enforce_if_nif", 2, probed_nif<only_enforce_if_nif>},
+      {"solution_bool_value_nif", 2, probed_nif<solution_bool_value_nif>},
+      {"solution_integer_value_nif", 2, probed_nif<solution_integer_value_nif>},
+      {"solve_nif", 2, probed_nif<solve_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"solve_with_callback_nif", 3, probed_nif<solve_with_callback_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"improve_nif", 4, probed_nif<improve_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"solve_lexicographic_nif", 3, probed_nif<solve_lexicographic_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"profile_model_nif", 2, probed_nif<profile_model_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"enumerate_to_file_nif", 4, probed_nif<enumerate_to_file_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"import_model_nif", 2, probed_nif<import_model_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"open_solution_file_nif", 1, probed_nif<open_solution_file_nif>, ERL_NIF_DIRTY_JOB_IO_BOUND},
+      {"read_solution_rows_nif", 3, probed_nif<read_solution_rows_nif>},
+      {"solution_pool_nif", 3, probed_nif<solution_pool_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"serialize_model_nif", 1, probed_nif<serialize_model_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"new_solve_cancel_nif", 0, probed_nif<new_solve_cancel_nif>},
+      {"cancel_solve_nif", 1, probed_nif<cancel_solve_nif>},
+      {"solve_serialized_nif", 3, probed_nif<solve_serialized_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"decode_response_nif", 1, probed_nif<decode_response_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"presolve_nif", 2, probed_nif<presolve_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"presolved_domain_nif", 2, probed_nif<presolved_domain_nif>},
+      {"solve_presolved_nif", 3, probed_nif<solve_presolved_nif>, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+      {"prod_expr1_constant2_nif", 2, probed_nif<prod_expr1_constant2_nif>},
+      {"prod_bool_var1_constant2_nif", 2, probed_nif<prod_bool_var1_constant2_nif>},
+      {"prod_int_var1_constant2_nif", 2, probed_nif<prod_int_var1_constant2_nif>},
+      {"sum_nif", 1, probed_nif<sized_nif<sum_nif, 0>>},
+      {"minus_nif", 2, probed_nif<minus_nif>},
+      {"expr_from_int_var_nif", 1, probed_nif<expr_from_int_var_nif>},
+      {"expr_from_bool_var_nif", 1, probed_nif<expr_from_bool_var_nif>},
+      {"expr_from_constant_nif", 1, probed_nif<expr_from_constant_nif>}};
+
+  const char *nif_function_name(NifFunction function)
+  {
+    for (const ErlNifFunc &nif_func : nif_funcs)
+    {
+      if (nif_func.fptr == function)
+      {
+        return nif_func.name;
+      }
+    }
+
+    return NULL;
+  }
 
   ERL_NIF_INIT(Elixir.Exhort.NIF.Nif, nif_funcs, &load, NULL, NULL, NULL)
 }
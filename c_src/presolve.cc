@@ -0,0 +1,271 @@
+#include <memory>
+#include <new>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/model.h"
+#include "ortools/sat/sat_parameters.pb.h"
+#include "wrappers.h"
+#include "cp_model_builder.h"
+#include "cp_solver_response.h"
+#include "linear_expression.h"
+#include "log_stream.h"
+#include "native_memory.h"
+#include "presolve.h"
+#include "solve_monitor.h"
+#include "solve_options.h"
+#include "utility.h"
+#include "worker_stats.h"
+#include "decode.h"
+
+using operations_research::sat::CpModelProto;
+using operations_research::sat::CpSolverResponse;
+using operations_research::sat::Model;
+using operations_research::sat::NewSatParameters;
+using operations_research::sat::SatParameters;
+
+using namespace std;
+
+// Presolve a built model once and solve it many times.
+//
+// CP-SAT's presolved model and its postsolve mapping are internal to the
+// solver, so the model is presolved through the public API instead: the model
+// without its objective is presolved alone, keeping every feasible solution,
+// and the domains the presolve derived are written back into a copy of the
+// model. That copy keeps the variable indexes of the built model, so the
+// responses of later solves map directly to the original variable handles.
+// Later solves start from the tightened domains and may replace the objective;
+// CP-SAT's own presolve still runs on them, for the reductions that can't be
+// expressed as domains.
+
+extern "C"
+{
+  ErlNifResourceType *PRESOLVED_MODEL_WRAPPER;
+
+  static ERL_NIF_TERM atom_minimize;
+  static ERL_NIF_TERM atom_maximize;
+  static ERL_NIF_TERM atom_nil;
+  static ERL_NIF_TERM atom_ok;
+  static ERL_NIF_TERM atom_error;
+  static ERL_NIF_TERM atom_no_tightened_domains;
+
+  static void free_presolved_model(ErlNifEnv *env, void *obj)
+  {
+    PresolvedModelWrapper *w = (PresolvedModelWrapper *)obj;
+    track_native_memory(PRESOLVED_MEMORY, &w->bytes, 0);
+    delete w->p;
+    release_native_resource(PRESOLVED_RESOURCE, sizeof(CpModelProto));
+  }
+
+  static int init_types(ErlNifEnv *env)
+  {
+    PRESOLVED_MODEL_WRAPPER = enif_open_resource_type(env, NULL, "PresolvedModelWrapper", free_presolved_model, (ErlNifResourceFlags)(ERL_NIF_RT_CREATE | ERL_NIF_RT_TAKEOVER), NULL);
+    return 0;
+  }
+
+  static int init_atoms(ErlNifEnv *env)
+  {
+    atom_minimize = enif_make_atom(env, "minimize");
+    atom_maximize = enif_make_atom(env, "maximize");
+    atom_nil = enif_make_atom(env, "nil");
+    atom_ok = enif_make_atom(env, "ok");
+    atom_error = enif_make_atom(env, "error");
+    atom_no_tightened_domains = enif_make_atom(env, "no_tightened_domains");
+    return 0;
+  }
+
+  int get_presolved_model(ErlNifEnv *env, ERL_NIF_TERM term, PresolvedModelWrapper **obj)
+  {
+    return enif_get_resource(env, term, PRESOLVED_MODEL_WRAPPER, (void **)obj);
+  }
+
+  // Write the domains derived by the presolve in `response` into `model`.
+  // Returns 0 when the response holds no domain for each variable, e.g. when
+  // the presolve was stopped by the time limit.
+  static int tighten_domains(CpModelProto *model, const CpSolverResponse &response)
+  {
+    if (response.status() == operations_research::sat::INFEASIBLE)
+    {
+      // An empty clause keeps the model infeasible for every later solve.
+      model->add_constraints()->mutable_bool_or();
+      return 1;
+    }
+
+    if (response.tightened_variables_size() != model->variables_size())
+    {
+      return 0;
+    }
+
+    for (int i = 0; i < model->variables_size(); ++i)
+    {
+      *model->mutable_variables(i)->mutable_domain() = response.tightened_variables(i).domain();
+    }
+
+    return 1;
+  }
+
+  ERL_NIF_TERM presolve_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    SolveOptions options;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!get_solve_options(env, argv[1], &options))
+    {
+      return enif_make_badarg(env);
+    }
+
+    const CpModelProto &built = builder_wrapper->p->Build();
+    track_native_memory(BUILDER_MEMORY, &builder_wrapper->bytes, built.SpaceUsedLong());
+
+    CpModelProto feasibility = built;
+    feasibility.clear_objective();
+
+    Model solver;
+    SatParameters parameters;
+    apply_solve_options(options, &parameters);
+    parameters.set_stop_after_presolve(true);
+    parameters.set_keep_all_feasible_solutions_in_presolve(true);
+    parameters.set_fill_tightened_domains_in_response(true);
+    solver.Add(NewSatParameters(parameters));
+    unique_ptr<LogStream> log_stream = attach_log_stream(env, options, &solver);
+
+    CpSolverResponse response = SolveCpModel(feasibility, &solver);
+
+    CpModelProto *presolved = new CpModelProto(built);
+    if (!tighten_domains(presolved, response))
+    {
+      delete presolved;
+      return enif_make_tuple2(env, atom_error, atom_no_tightened_domains);
+    }
+
+    PresolvedModelWrapper *presolved_wrapper = (PresolvedModelWrapper *)enif_alloc_resource(PRESOLVED_MODEL_WRAPPER, sizeof(PresolvedModelWrapper));
+    if (presolved_wrapper == NULL)
+    {
+      delete presolved;
+      return enif_make_badarg(env);
+    }
+
+    presolved_wrapper->p = presolved;
+    count_native_resource(PRESOLVED_RESOURCE, sizeof(CpModelProto));
+    new (&presolved_wrapper->bytes) atomic<size_t>(0);
+    track_native_memory(PRESOLVED_MEMORY, &presolved_wrapper->bytes, presolved_wrapper->p->SpaceUsedLong());
+
+    ERL_NIF_TERM term = enif_make_resource(env, presolved_wrapper);
+    enif_release_resource(presolved_wrapper);
+
+    return enif_make_tuple2(env, atom_ok, term);
+  }
+
+  // presolved_domain_nif(presolved, var) returns the presolved domain of an
+  // integer or boolean variable as a list of `{min, max}` intervals.
+  ERL_NIF_TERM presolved_domain_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    PresolvedModelWrapper *presolved_wrapper;
+    int index;
+
+    if (!get_presolved_model(env, argv[0], &presolved_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!get_var_index(env, argv[1], &index) || index < 0 || index >= presolved_wrapper->p->variables_size())
+    {
+      return enif_make_badarg(env);
+    }
+
+    const auto &domain = presolved_wrapper->p->variables(index).domain();
+    ERL_NIF_TERM intervals = enif_make_list(env, 0);
+    for (int i = domain.size() - 2; i >= 0; i -= 2)
+    {
+      ERL_NIF_TERM interval = enif_make_tuple2(env, enif_make_int64(env, domain[i]), enif_make_int64(env, domain[i + 1]));
+      intervals = enif_make_list_cell(env, interval, intervals);
+    }
+
+    return intervals;
+  }
+
+  // Replace the objective of `model` with `term`, `{:minimize | :maximize,
+  // expr}`, or keep it when `term` is nil.
+  static int get_objective(ErlNifEnv *env, ERL_NIF_TERM term, CpModelProto *model)
+  {
+    if (enif_is_identical(term, atom_nil))
+    {
+      return 1;
+    }
+
+    const ERL_NIF_TERM *elements;
+    int arity;
+    LinearExprWrapper *expr;
+
+    if (!enif_get_tuple(env, term, &arity, &elements) || arity != 2)
+    {
+      return 0;
+    }
+
+    if (!decode(env, elements[1], &expr))
+    {
+      return 0;
+    }
+
+    if (enif_is_identical(elements[0], atom_maximize))
+    {
+      set_objective(model, *expr->p, true);
+    }
+    else if (enif_is_identical(elements[0], atom_minimize))
+    {
+      set_objective(model, *expr->p, false);
+    }
+    else
+    {
+      return 0;
+    }
+
+    return 1;
+  }
+
+  ERL_NIF_TERM solve_presolved_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    PresolvedModelWrapper *presolved_wrapper;
+    SolveOptions options;
+
+    if (!get_presolved_model(env, argv[0], &presolved_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    CpModelProto model = *presolved_wrapper->p;
+
+    if (!get_objective(env, argv[1], &model))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!get_solve_options(env, argv[2], &options))
+    {
+      return enif_make_badarg(env);
+    }
+
+    Model solver;
+    SatParameters parameters;
+    apply_solve_options(options, &parameters);
+    solver.Add(NewSatParameters(parameters));
+    unique_ptr<LogStream> log_stream = attach_log_stream(env, options, &solver);
+    unique_ptr<SolveMonitor> monitor = attach_solve_monitor(options, model, &solver);
+    unique_ptr<WorkerStats> stats = attach_worker_stats(options, &solver);
+
+    CpSolverResponse response = SolveCpModel(model, &solver);
+    return make_solve_result(env, response, monitor.get(), stats.get());
+  }
+
+  int load_presolve(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
+  {
+    if (init_types(env) == -1 || init_atoms(env) == -1)
+      return -1;
+    else
+      return 0;
+  }
+}
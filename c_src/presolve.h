@@ -0,0 +1,20 @@
+#ifndef __PRESOLVE_H__
+#define __PRESOLVE_H__
+
+#include "erl_nif.h"
+#include "wrappers.h"
+
+extern "C"
+{
+  int load_presolve(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
+
+  int get_presolved_model(ErlNifEnv *env, ERL_NIF_TERM term, PresolvedModelWrapper **obj);
+
+  ERL_NIF_TERM presolve_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM presolved_domain_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM solve_presolved_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include <cmath>
+#include <string>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/model.h"
+#include "ortools/util/logging.h"
+#include "probes.h"
+
+using operations_research::SolverLogger;
+using operations_research::sat::NewFeasibleSolutionObserver;
+
+using namespace std;
+
+#ifdef EXHORT_USDT
+extern "C"
+{
+  // The semaphores of the probes, in the section `sys/sdt.h` expects.
+  __extension__ unsigned short exhort_nif__entry_semaphore __attribute__((unused)) __attribute__((section(".probes")));
+  __extension__ unsigned short exhort_nif__exit_semaphore __attribute__((unused)) __attribute__((section(".probes")));
+  __extension__ unsigned short exhort_solve__phase_semaphore __attribute__((unused)) __attribute__((section(".probes")));
+}
+#endif
+
+extern "C"
+{
+  // Defined with the NIF table.
+  const char *nif_function_name(NifFunction function);
+
+  const char *probed_nif_name(NifFunction function)
+  {
+    const char *name = nif_function_name(function);
+    return name != NULL ? name : "unknown";
+  }
+
+  void probed_nif_arguments(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[], long *terms, long *bytes)
+  {
+    for (int i = 0; i < argc; ++i)
+    {
+      unsigned int length;
+      int arity;
+      const ERL_NIF_TERM *elements;
+      size_t size;
+      ErlNifBinary binary;
+
+      if (enif_get_list_length(env, argv[i], &length))
+      {
+        *terms += length;
+      }
+      else if (enif_get_tuple(env, argv[i], &arity, &elements))
+      {
+        *terms += arity;
+      }
+      else if (enif_get_map_size(env, argv[i], &size))
+      {
+        *terms += size;
+      }
+      else if (enif_inspect_binary(env, argv[i], &binary))
+      {
+        *bytes += binary.size;
+      }
+    }
+  }
+}
+
+SolveProbes::SolveProbes(const CpModelProto &proto)
+    : solutions_(0), searching_(false)
+{
+  EXHORT_PROBE3(solve__phase, "presolve", (long)proto.variables_size(), (long)proto.constraints_size());
+}
+
+void SolveProbes::Attach(Model *model)
+{
+  // CP-SAT logs the presolved model once presolve is done.
+  model->GetOrCreate<SolverLogger>()->AddInfoLoggingCallback([this](const string &line)
+                                                             {
+                                                               if (line.rfind("Presolved ", 0) == 0 && !searching_.exchange(true))
+                                                               {
+                                                                 EXHORT_PROBE3(solve__phase, "search", 0L, 0L);
+                                                               } });
+  model->Add(NewFeasibleSolutionObserver([this](const CpSolverResponse &r)
+                                         {
+                                           ++solutions_;
+                                           EXHORT_PROBE3(solve__phase, "solution", solutions_, (long)llround(r.objective_value())); }));
+}
+
+void SolveProbes::Finish(const CpSolverResponse &response)
+{
+  EXHORT_PROBE3(solve__phase, "done", (long)response.status(), (long)llround(response.wall_time() * 1e6));
+}
+
+bool solve_probes_enabled()
+{
+  return EXHORT_PROBE_ENABLED(solve__phase);
+}
+
+unique_ptr<SolveProbes> attach_solve_probes(const CpModelProto &proto, Model *model)
+{
+  if (!solve_probes_enabled())
+  {
+    return nullptr;
+  }
+
+  unique_ptr<SolveProbes> probes(new SolveProbes(proto));
+  probes->Attach(model);
+  return probes;
+}
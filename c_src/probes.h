@@ -0,0 +1,116 @@
+#ifndef __PROBES_H__
+#define __PROBES_H__
+
+#include <atomic>
+#include <memory>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/model.h"
+
+using operations_research::sat::CpModelProto;
+using operations_research::sat::CpSolverResponse;
+using operations_research::sat::Model;
+
+// Static tracepoints (USDT) for `perf` and `bpftrace`, in the `exhort`
+// provider:
+//
+// - `nif__entry(name, argc, terms, bytes)` - A NIF was called. `terms` is the
+//   total length of its list, tuple and map arguments and `bytes` the total
+//   size of its binary arguments.
+// - `nif__exit(name, raised)` - The NIF returned, `raised` is 1 when it raised.
+// - `solve__phase(phase, a, b)` - A solve reached `phase`: `"presolve"` with
+//   the number of variables and constraints, `"search"` once presolve is done,
+//   `"solution"` with the solution number and its rounded objective and
+//   `"done"` with the status and the wall time in microseconds.
+//
+// The probes are compiled in when `sys/sdt.h` is available. Each probe has a
+// semaphore, set by the tracer while the probe is attached, so the arguments
+// are only computed, and the solve phases only observed, while tracing.
+//
+//     bpftrace -e 'usdt:priv/lib/nif.so:exhort:nif__entry { @[str(arg0)] = count(); }'
+
+#ifdef EXHORT_USDT
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+extern "C"
+{
+  extern unsigned short exhort_nif__entry_semaphore;
+  extern unsigned short exhort_nif__exit_semaphore;
+  extern unsigned short exhort_solve__phase_semaphore;
+}
+
+#define EXHORT_PROBE_ENABLED(name) __builtin_expect(exhort_##name##_semaphore != 0, 0)
+#define EXHORT_PROBE2(name, a, b) STAP_PROBE2(exhort, name, a, b)
+#define EXHORT_PROBE3(name, a, b, c) STAP_PROBE3(exhort, name, a, b, c)
+#define EXHORT_PROBE4(name, a, b, c, d) STAP_PROBE4(exhort, name, a, b, c, d)
+#else
+#define EXHORT_PROBE_ENABLED(name) 0
+#define EXHORT_PROBE2(name, a, b)
+#define EXHORT_PROBE3(name, a, b, c)
+#define EXHORT_PROBE4(name, a, b, c, d)
+#endif
+
+typedef ERL_NIF_TERM (*NifFunction)(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+extern "C"
+{
+  // The name under which `function` is registered.
+  const char *probed_nif_name(NifFunction function);
+
+  // The total length of the list, tuple and map arguments of a NIF and the
+  // total size of its binary arguments.
+  void probed_nif_arguments(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[], long *terms, long *bytes);
+}
+
+// Wrap the NIF `F` with the `nif__entry` and `nif__exit` probes. Registered in
+// the NIF table in place of `F`.
+template <NifFunction F>
+ERL_NIF_TERM probed_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+#ifdef EXHORT_USDT
+  if (!EXHORT_PROBE_ENABLED(nif__entry) && !EXHORT_PROBE_ENABLED(nif__exit))
+  {
+    return F(env, argc, argv);
+  }
+
+  const char *name = probed_nif_name(probed_nif<F>);
+  long terms = 0;
+  long bytes = 0;
+  probed_nif_arguments(env, argc, argv, &terms, &bytes);
+  EXHORT_PROBE4(nif__entry, name, argc, terms, bytes);
+
+  ERL_NIF_TERM result = F(env, argc, argv);
+
+  EXHORT_PROBE2(nif__exit, name, enif_is_exception(env, result) ? 1 : 0);
+  return result;
+#else
+  return F(env, argc, argv);
+#endif
+}
+
+// Fire the `solve__phase` probes of one solve.
+class SolveProbes
+{
+public:
+  explicit SolveProbes(const CpModelProto &proto);
+
+  // Register the log and solution callbacks with `model`.
+  void Attach(Model *model);
+
+  // Fire the `done` phase once the solve has returned.
+  void Finish(const CpSolverResponse &response);
+
+private:
+  long solutions_;
+  std::atomic<bool> searching_;
+};
+
+// Whether the `solve__phase` probe is being traced. The solver log is then
+// turned on, since the end of presolve is found in it.
+bool solve_probes_enabled();
+
+// The probes of a solve of `proto`, or nullptr when they are not traced.
+std::unique_ptr<SolveProbes> attach_solve_probes(const CpModelProto &proto, Model *model);
+
+#endif
@@ -0,0 +1,233 @@
+#include <climits>
+#include <memory>
+#include <mutex>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/model.h"
+#include "ortools/sat/sat_parameters.pb.h"
+#include "wrappers.h"
+#include "cp_model_builder.h"
+#include "cp_solver_response.h"
+#include "native_memory.h"
+#include "remote_solve.h"
+#include "solve_monitor.h"
+#include "solve_options.h"
+#include "worker_stats.h"
+#include "decode.h"
+
+using operations_research::sat::CpModelProto;
+using operations_research::sat::CpSolverResponse;
+using operations_research::sat::Model;
+using operations_research::sat::NewSatParameters;
+using operations_research::sat::SatParameters;
+using operations_research::sat::StopSearch;
+
+using namespace std;
+
+// Solve a model built on another node.
+//
+// Resources can't leave the node that made them, so the built model is sent
+// as its serialized `CpModelProto` and the response comes back as its
+// serialized `CpSolverResponse`. The response is decoded into a response
+// resource on the calling node, where the variable handles of the model it
+// was built from read their values from it, as both use the model's indexes.
+//
+// A solve may be cancelled from another process through the handle it was
+// started with, e.g. once the caller waiting for it has gone.
+
+// The cancellation of one solve. `model` is the solver's model while the solve
+// runs.
+struct SolveCancel
+{
+  mutex lock;
+  Model *model = nullptr;
+  bool cancelled = false;
+};
+
+extern "C"
+{
+  typedef struct
+  {
+    SolveCancel *p;
+  } SolveCancelWrapper;
+
+  ErlNifResourceType *SOLVE_CANCEL_WRAPPER;
+
+  static void free_solve_cancel(ErlNifEnv *env, void *obj)
+  {
+    SolveCancelWrapper *w = (SolveCancelWrapper *)obj;
+    delete w->p;
+  }
+
+  int load_remote_solve(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
+  {
+    SOLVE_CANCEL_WRAPPER = enif_open_resource_type(env, NULL, "SolveCancelWrapper", free_solve_cancel, (ErlNifResourceFlags)(ERL_NIF_RT_CREATE | ERL_NIF_RT_TAKEOVER), NULL);
+    return 0;
+  }
+
+  static int make_serialized(ErlNifEnv *env, const google::protobuf::Message &message, ERL_NIF_TERM *term)
+  {
+    size_t size = message.ByteSizeLong();
+    if (size > INT_MAX)
+    {
+      return 0;
+    }
+
+    ErlNifBinary binary;
+    if (!enif_alloc_binary(size, &binary))
+    {
+      return 0;
+    }
+
+    if (!message.SerializeToArray(binary.data, size))
+    {
+      enif_release_binary(&binary);
+      return 0;
+    }
+
+    *term = enif_make_binary(env, &binary);
+    return 1;
+  }
+
+  static int parse_serialized(ErlNifEnv *env, ERL_NIF_TERM term, google::protobuf::Message *message)
+  {
+    ErlNifBinary binary;
+    return enif_inspect_binary(env, term, &binary) &&
+           binary.size <= INT_MAX &&
+           message->ParseFromArray(binary.data, binary.size);
+  }
+
+  // serialize_model_nif(builder) returns the built model as a binary.
+  ERL_NIF_TERM serialize_model_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    ERL_NIF_TERM result;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    const CpModelProto &proto = builder_wrapper->p->Build();
+    track_native_memory(BUILDER_MEMORY, &builder_wrapper->bytes, proto.SpaceUsedLong());
+
+    if (!make_serialized(env, proto, &result))
+    {
+      return enif_make_badarg(env);
+    }
+
+    return result;
+  }
+
+  // new_solve_cancel_nif() returns a handle to cancel a solve with.
+  ERL_NIF_TERM new_solve_cancel_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    SolveCancelWrapper *cancel_wrapper = (SolveCancelWrapper *)enif_alloc_resource(SOLVE_CANCEL_WRAPPER, sizeof(SolveCancelWrapper));
+    if (cancel_wrapper == NULL)
+      return enif_make_badarg(env);
+
+    cancel_wrapper->p = new SolveCancel();
+    ERL_NIF_TERM term = enif_make_resource(env, cancel_wrapper);
+    enif_release_resource(cancel_wrapper);
+
+    return term;
+  }
+
+  // cancel_solve_nif(cancel) stops the solve started with `cancel`, or makes
+  // it stop as soon as it starts.
+  ERL_NIF_TERM cancel_solve_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    SolveCancelWrapper *cancel_wrapper;
+
+    if (!enif_get_resource(env, argv[0], SOLVE_CANCEL_WRAPPER, (void **)&cancel_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    lock_guard<mutex> lock(cancel_wrapper->p->lock);
+    cancel_wrapper->p->cancelled = true;
+    if (cancel_wrapper->p->model != nullptr)
+    {
+      StopSearch(cancel_wrapper->p->model);
+    }
+
+    return enif_make_atom(env, "ok");
+  }
+
+  // solve_serialized_nif(model, options, cancel) solves a model serialized by
+  // `serialize_model_nif`. The options are those of `solve_nif`, other than
+  // the log and the progress, which are sent to local processes. Returns
+  // `{response, stats}`, the serialized response and a map of its
+  // `stop_reason` and `workers` when there are any.
+  ERL_NIF_TERM solve_serialized_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    CpModelProto proto;
+    SolveOptions options;
+    SolveCancelWrapper *cancel_wrapper;
+
+    if (!parse_serialized(env, argv[0], &proto))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!get_solve_options(env, argv[1], &options) || options.has_log_pid || options.has_progress_pid)
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!enif_get_resource(env, argv[2], SOLVE_CANCEL_WRAPPER, (void **)&cancel_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    Model model;
+    SatParameters parameters;
+    apply_solve_options(options, &parameters);
+    model.Add(NewSatParameters(parameters));
+    unique_ptr<SolveMonitor> monitor = attach_solve_monitor(options, proto, &model);
+    unique_ptr<WorkerStats> stats = attach_worker_stats(options, &model);
+
+    // The handle is kept alive by the arguments for the whole call.
+    SolveCancel *cancel = cancel_wrapper->p;
+    {
+      lock_guard<mutex> lock(cancel->lock);
+      cancel->model = &model;
+      if (cancel->cancelled)
+      {
+        StopSearch(&model);
+      }
+    }
+
+    CpSolverResponse response = SolveCpModel(proto, &model);
+
+    {
+      lock_guard<mutex> lock(cancel->lock);
+      cancel->model = nullptr;
+    }
+
+    ERL_NIF_TERM serialized;
+    if (!make_serialized(env, response, &serialized))
+    {
+      return enif_make_badarg(env);
+    }
+
+    ERL_NIF_TERM stats_map = put_solve_stats(env, enif_make_new_map(env), response, monitor.get(), stats.get());
+
+    return enif_make_tuple2(env, serialized, stats_map);
+  }
+
+  // decode_response_nif(response) makes a response resource from a response
+  // serialized by `solve_serialized_nif`, returning the same map as
+  // `solve_nif`.
+  ERL_NIF_TERM decode_response_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    CpSolverResponse response;
+
+    if (!parse_serialized(env, argv[0], &response))
+    {
+      return enif_make_badarg(env);
+    }
+
+    return make_cp_solver_response(env, response);
+  }
+}
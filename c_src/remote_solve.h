@@ -0,0 +1,21 @@
+#ifndef __REMOTE_SOLVE_H__
+#define __REMOTE_SOLVE_H__
+
+#include "erl_nif.h"
+
+extern "C"
+{
+  int load_remote_solve(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
+
+  ERL_NIF_TERM serialize_model_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM new_solve_cancel_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM cancel_solve_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM solve_serialized_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM decode_response_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+}
+
+#endif
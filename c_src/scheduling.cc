@@ -0,0 +1,40 @@
+#include <cstdint>
+#include "erl_nif.h"
+#include "scheduling.h"
+
+extern "C"
+{
+  long nif_argument_length(ErlNifEnv *env, ERL_NIF_TERM term, size_t element_size)
+  {
+    unsigned int length;
+    int arity;
+    const ERL_NIF_TERM *elements;
+    ErlNifBinary binary;
+
+    if (enif_get_list_length(env, term, &length))
+    {
+      return length;
+    }
+
+    if (enif_get_tuple(env, term, &arity, &elements))
+    {
+      return arity;
+    }
+
+    if (enif_inspect_binary(env, term, &binary))
+    {
+      return binary.size / element_size;
+    }
+
+    return 0;
+  }
+
+  void consume_elements(ErlNifEnv *env, long elements)
+  {
+    int percent = (int)(elements * 100 / TIMESLICE_ELEMENTS);
+    if (percent > 0)
+    {
+      enif_consume_timeslice(env, percent > 100 ? 100 : percent);
+    }
+  }
+}
@@ -0,0 +1,50 @@
+#ifndef __SCHEDULING_H__
+#define __SCHEDULING_H__
+
+#include <cstddef>
+#include <cstdint>
+#include "erl_nif.h"
+#include "probes.h"
+
+// Scheduling of the model-building NIFs that take lists of arbitrary length.
+//
+// A NIF on a normal scheduler should return within about a millisecond. The
+// work of these NIFs grows with the length of one of their arguments, so they
+// are registered through `sized_nif`, which:
+//
+// - runs short calls directly and reports the share of the timeslice they used
+//   with `enif_consume_timeslice`;
+// - reschedules calls of more than a timeslice of work onto a dirty CPU
+//   scheduler with `enif_schedule_nif`.
+
+// The number of elements handled in about a millisecond.
+#define TIMESLICE_ELEMENTS 10000
+
+extern "C"
+{
+  // The number of elements in a list, tuple or binary of `element_size`-byte
+  // values, or 0.
+  long nif_argument_length(ErlNifEnv *env, ERL_NIF_TERM term, size_t element_size);
+
+  // Report the share of the timeslice used by handling `elements` elements.
+  void consume_elements(ErlNifEnv *env, long elements);
+}
+
+// Wrap the NIF `F`, whose work grows with the length of its argument `A`. When
+// `A` is a binary, it holds values of `S` bytes, by default int32 indexes.
+template <NifFunction F, int A, size_t S = sizeof(int32_t)>
+ERL_NIF_TERM sized_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  long elements = A < argc ? nif_argument_length(env, argv[A], S) : 0;
+
+  if (elements > TIMESLICE_ELEMENTS)
+  {
+    return enif_schedule_nif(env, probed_nif_name(probed_nif<sized_nif<F, A, S>>), ERL_NIF_DIRTY_JOB_CPU_BOUND, F, argc, argv);
+  }
+
+  ERL_NIF_TERM result = F(env, argc, argv);
+  consume_elements(env, elements);
+  return result;
+}
+
+#endif
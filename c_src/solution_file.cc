@@ -0,0 +1,466 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/model.h"
+#include "ortools/sat/sat_parameters.pb.h"
+#include "ortools/util/time_limit.h"
+#include "wrappers.h"
+#include "cp_model_builder.h"
+#include "cp_solver_response.h"
+#include "log_stream.h"
+#include "native_memory.h"
+#include "solution_file.h"
+#include "solve_options.h"
+#include "utility.h"
+#include "core/solution.h"
+#include "decode.h"
+
+using operations_research::TimeLimit;
+using operations_research::sat::CpModelProto;
+using operations_research::sat::CpSolverResponse;
+using operations_research::sat::Model;
+using operations_research::sat::NewFeasibleSolutionObserver;
+using operations_research::sat::NewSatParameters;
+using operations_research::sat::SatParameters;
+
+using namespace std;
+
+// Enumerate the solutions of a model into an append-only file instead of
+// sending each one as a message, and read them back through mmap.
+
+#define SOLUTION_FILE_MAGIC "EXHSOL01"
+#define SOLUTION_FILE_INT64 0
+#define SOLUTION_FILE_BITSET 1
+
+extern "C"
+{
+  ErlNifResourceType *SOLUTION_FILE_WRAPPER;
+
+  static ERL_NIF_TERM atom_max_solutions;
+  static ERL_NIF_TERM atom_format;
+  static ERL_NIF_TERM atom_int64;
+  static ERL_NIF_TERM atom_bitset;
+
+  static void free_solution_file(ErlNifEnv *env, void *obj)
+  {
+    SolutionFileWrapper *w = (SolutionFileWrapper *)obj;
+    if (w->data != NULL)
+    {
+      munmap((void *)w->data, w->size);
+    }
+    release_native_resource(SOLUTION_FILE_RESOURCE, w->size);
+  }
+
+  static int init_types(ErlNifEnv *env)
+  {
+    SOLUTION_FILE_WRAPPER = enif_open_resource_type(env, NULL, "SolutionFileWrapper", free_solution_file, (ErlNifResourceFlags)(ERL_NIF_RT_CREATE | ERL_NIF_RT_TAKEOVER), NULL);
+    return 0;
+  }
+
+  static int init_atoms(ErlNifEnv *env)
+  {
+    atom_max_solutions = enif_make_atom(env, "max_solutions");
+    atom_format = enif_make_atom(env, "format");
+    atom_int64 = enif_make_atom(env, "int64");
+    atom_bitset = enif_make_atom(env, "bitset");
+    return 0;
+  }
+
+  static ERL_NIF_TERM make_error(ErlNifEnv *env, int error)
+  {
+    const char *reason;
+    switch (error)
+    {
+    case ENOENT:
+      reason = "enoent";
+      break;
+    case EACCES:
+      reason = "eacces";
+      break;
+    case ENOSPC:
+      reason = "enospc";
+      break;
+    default:
+      reason = "eio";
+    }
+
+    return enif_make_tuple2(env, enif_make_atom(env, "error"), enif_make_atom(env, reason));
+  }
+
+  static int get_path(ErlNifEnv *env, ERL_NIF_TERM term, string *path)
+  {
+    ErlNifBinary binary;
+    if (!enif_inspect_binary(env, term, &binary))
+    {
+      return 0;
+    }
+
+    path->assign((const char *)binary.data, binary.size);
+    return 1;
+  }
+
+  // Append the projection of each solution to a file as a fixed-width row.
+  class SolutionWriter
+  {
+  public:
+    SolutionWriter(FILE *file, const vector<int> &vars, uint32_t format, uint64_t max_solutions)
+        : file_(file), vars_(vars), format_(format), max_solutions_(max_solutions), rows_(0), failed_(false), error_(0), stop_(false)
+    {
+      if (format_ == SOLUTION_FILE_BITSET)
+      {
+        bits_.resize(RowBytes());
+      }
+      else
+      {
+        values_.resize(vars_.size());
+      }
+    }
+
+    uint64_t RowBytes() const
+    {
+      return format_ == SOLUTION_FILE_BITSET ? bitset_row_bytes(vars_.size()) : vars_.size() * sizeof(int64_t);
+    }
+
+    void Attach(Model *model)
+    {
+      model->GetOrCreate<TimeLimit>()->RegisterExternalBooleanAsLimit(&stop_);
+      model->Add(NewFeasibleSolutionObserver([this](const CpSolverResponse &r)
+                                             { Write(r); }));
+    }
+
+    uint64_t Rows() const { return rows_; }
+    bool Failed() const { return failed_; }
+    int Error() const { return error_; }
+
+  private:
+    void Write(const CpSolverResponse &response)
+    {
+      if (failed_ || stop_)
+      {
+        return;
+      }
+
+      const void *row;
+      if (format_ == SOLUTION_FILE_BITSET)
+      {
+        extract_bitset_row(response, vars_.data(), vars_.size(), bits_.data());
+        row = bits_.data();
+      }
+      else
+      {
+        extract_int64_row(response, vars_.data(), vars_.size(), values_.data());
+        row = values_.data();
+      }
+
+      uint64_t row_bytes = RowBytes();
+      if (row_bytes > 0 && fwrite(row, row_bytes, 1, file_) != 1)
+      {
+        error_ = errno;
+        failed_ = true;
+        stop_ = true;
+        return;
+      }
+
+      ++rows_;
+      if (max_solutions_ > 0 && rows_ >= max_solutions_)
+      {
+        stop_ = true;
+      }
+    }
+
+    FILE *file_;
+    const vector<int> &vars_;
+    uint32_t format_;
+    uint64_t max_solutions_;
+    uint64_t rows_;
+    // A row is packed into the buffer of its format, so int64 values are
+    // written from properly aligned storage.
+    vector<unsigned char> bits_;
+    vector<int64_t> values_;
+    bool failed_;
+    int error_;
+    atomic<bool> stop_;
+  };
+
+  // enumerate_to_file_nif(builder, path, vars, options), where the options may
+  // also give `max_solutions` and `format`, `:int64` or `:bitset`.
+  ERL_NIF_TERM enumerate_to_file_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    string path;
+    vector<int> vars;
+    SolveOptions options;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!get_path(env, argv[1], &path))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!decode_var_indexes(env, argv[2], builder_wrapper->p->Proto().variables_size(), &vars))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!get_solve_options(env, argv[3], &options))
+    {
+      return enif_make_badarg(env);
+    }
+
+    ErlNifUInt64 max_solutions = 0;
+    ERL_NIF_TERM term;
+    if (enif_get_map_value(env, argv[3], atom_max_solutions, &term) &&
+        !enif_get_uint64(env, term, &max_solutions))
+    {
+      return enif_make_badarg(env);
+    }
+
+    // Enumeration is over the feasible solutions, whatever the objective.
+    CpModelProto model = builder_wrapper->p->Build();
+    track_native_memory(BUILDER_MEMORY, &builder_wrapper->bytes, model.SpaceUsedLong());
+    model.clear_objective();
+
+    uint32_t format = SOLUTION_FILE_BITSET;
+    for (int index : vars)
+    {
+      if (!is_boolean_var(model, index))
+      {
+        format = SOLUTION_FILE_INT64;
+      }
+    }
+
+    if (enif_get_map_value(env, argv[3], atom_format, &term))
+    {
+      if (enif_is_identical(term, atom_int64))
+      {
+        format = SOLUTION_FILE_INT64;
+      }
+      else if (!enif_is_identical(term, atom_bitset) || format != SOLUTION_FILE_BITSET)
+      {
+        return enif_make_badarg(env);
+      }
+    }
+
+    // The solutions are written to a temporary file that replaces `path` once
+    // complete, as truncating `path` in place would fault any mapping of it
+    // that is still open.
+    string temp_path = path + ".XXXXXX";
+    int fd = mkstemp(&temp_path[0]);
+    if (fd < 0)
+    {
+      return make_error(env, errno);
+    }
+
+    FILE *file = fdopen(fd, "wb");
+    if (file == NULL)
+    {
+      int error = errno;
+      close(fd);
+      unlink(temp_path.c_str());
+      return make_error(env, error);
+    }
+
+    SolutionFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SOLUTION_FILE_MAGIC, sizeof(header.magic));
+    header.format = format;
+    header.num_vars = vars.size();
+
+    uint64_t indexes_end = sizeof(header) + vars.size() * sizeof(int32_t);
+    header.data_offset = (indexes_end + 7) & ~(uint64_t)7;
+
+    SolutionWriter writer(file, vars, format, max_solutions);
+    header.row_bytes = writer.RowBytes();
+
+    vector<int32_t> indexes(vars.begin(), vars.end());
+    vector<unsigned char> padding(header.data_offset - indexes_end, 0);
+    int error = 0;
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(indexes.data(), sizeof(int32_t), indexes.size(), file) != indexes.size() ||
+        fwrite(padding.data(), 1, padding.size(), file) != padding.size())
+    {
+      error = errno;
+    }
+
+    CpSolverResponse response;
+    if (error == 0)
+    {
+      Model solver;
+      SatParameters parameters;
+      parameters.set_enumerate_all_solutions(true);
+      apply_solve_options(options, &parameters);
+      solver.Add(NewSatParameters(parameters));
+      unique_ptr<LogStream> log_stream = attach_log_stream(env, options, &solver);
+      writer.Attach(&solver);
+
+      response = SolveCpModel(model, &solver);
+
+      // The row count is only written once every row is.
+      header.num_rows = writer.Rows();
+      if (writer.Failed())
+      {
+        error = writer.Error();
+      }
+      else if (fseek(file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, file) != 1)
+      {
+        error = errno;
+      }
+    }
+
+    if (fclose(file) != 0 && error == 0)
+    {
+      error = errno;
+    }
+
+    if (error == 0 && rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+      error = errno;
+    }
+
+    if (error != 0)
+    {
+      unlink(temp_path.c_str());
+      return make_error(env, error);
+    }
+
+    ERL_NIF_TERM result = make_cp_solver_response(env, response);
+    result = put_map_value(env, result, "solutions", enif_make_uint64(env, header.num_rows));
+    result = put_map_value(env, result, "format", format == SOLUTION_FILE_BITSET ? atom_bitset : atom_int64);
+
+    return enif_make_tuple2(env, enif_make_atom(env, "ok"), result);
+  }
+
+  static const SolutionFileHeader *get_header(const SolutionFileWrapper *w)
+  {
+    return (const SolutionFileHeader *)w->data;
+  }
+
+  // open_solution_file_nif(path) maps the file and returns
+  // `{:ok, res, %{"format" => _, "vars" => [index], "rows" => _, "row_bytes" => _}}`.
+  ERL_NIF_TERM open_solution_file_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    string path;
+
+    if (!get_path(env, argv[0], &path))
+    {
+      return enif_make_badarg(env);
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      return make_error(env, errno);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SolutionFileHeader))
+    {
+      close(fd);
+      return enif_make_tuple2(env, enif_make_atom(env, "error"), enif_make_atom(env, "invalid"));
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+      int error = errno;
+      close(fd);
+      return make_error(env, error);
+    }
+    close(fd);
+
+    SolutionFileWrapper *solution_file_wrapper = (SolutionFileWrapper *)enif_alloc_resource(SOLUTION_FILE_WRAPPER, sizeof(SolutionFileWrapper));
+    if (solution_file_wrapper == NULL)
+    {
+      munmap(data, st.st_size);
+      return enif_make_badarg(env);
+    }
+
+    solution_file_wrapper->data = (const unsigned char *)data;
+    solution_file_wrapper->size = st.st_size;
+    count_native_resource(SOLUTION_FILE_RESOURCE, solution_file_wrapper->size);
+    ERL_NIF_TERM term = enif_make_resource(env, solution_file_wrapper);
+    enif_release_resource(solution_file_wrapper);
+
+    const SolutionFileHeader *header = get_header(solution_file_wrapper);
+    // Compared by division, as the sizes in a corrupt header may overflow.
+    size_t size = solution_file_wrapper->size;
+    if (memcmp(header->magic, SOLUTION_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->data_offset < sizeof(SolutionFileHeader) ||
+        header->data_offset > size ||
+        header->num_vars > (header->data_offset - sizeof(SolutionFileHeader)) / sizeof(int32_t) ||
+        (header->row_bytes > 0 && header->num_rows > (size - header->data_offset) / header->row_bytes))
+    {
+      return enif_make_tuple2(env, enif_make_atom(env, "error"), enif_make_atom(env, "invalid"));
+    }
+
+    const int32_t *indexes = (const int32_t *)(solution_file_wrapper->data + sizeof(SolutionFileHeader));
+    vector<ERL_NIF_TERM> vars;
+    for (uint32_t i = 0; i < header->num_vars; ++i)
+    {
+      vars.push_back(enif_make_int(env, indexes[i]));
+    }
+
+    ERL_NIF_TERM info = enif_make_new_map(env);
+    info = put_map_value(env, info, "format", header->format == SOLUTION_FILE_BITSET ? atom_bitset : atom_int64);
+    info = put_map_value(env, info, "vars", enif_make_list_from_array(env, vars.data(), vars.size()));
+    info = put_map_value(env, info, "rows", enif_make_uint64(env, header->num_rows));
+    info = put_map_value(env, info, "row_bytes", enif_make_uint64(env, header->row_bytes));
+
+    return enif_make_tuple3(env, enif_make_atom(env, "ok"), term, info);
+  }
+
+  // read_solution_rows_nif(res, first, count) returns the rows `first` to
+  // `first + count - 1` as one binary that refers to the mapped pages without
+  // copying them.
+  ERL_NIF_TERM read_solution_rows_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    SolutionFileWrapper *solution_file_wrapper;
+    ErlNifUInt64 first;
+    ErlNifUInt64 count;
+
+    if (!enif_get_resource(env, argv[0], SOLUTION_FILE_WRAPPER, (void **)&solution_file_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!enif_get_uint64(env, argv[1], &first) || !enif_get_uint64(env, argv[2], &count))
+    {
+      return enif_make_badarg(env);
+    }
+
+    const SolutionFileHeader *header = get_header(solution_file_wrapper);
+    if (first > header->num_rows)
+    {
+      return enif_make_badarg(env);
+    }
+
+    count = min(count, (ErlNifUInt64)(header->num_rows - first));
+
+    return enif_make_resource_binary(env, solution_file_wrapper,
+                                     solution_file_wrapper->data + header->data_offset + first * header->row_bytes,
+                                     count * header->row_bytes);
+  }
+
+  int load_solution_file(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
+  {
+    if (init_types(env) == -1 || init_atoms(env) == -1)
+      return -1;
+    else
+      return 0;
+  }
+}
@@ -0,0 +1,42 @@
+#ifndef __SOLUTION_FILE_H__
+#define __SOLUTION_FILE_H__
+
+#include <cstdint>
+#include "erl_nif.h"
+
+extern "C"
+{
+  // The header at the start of a solution file. Values are in the byte order
+  // of the host that wrote the file.
+  //
+  // The header is followed by the `num_vars` int32 indexes of the projected
+  // variables, then, at `data_offset`, by `num_rows` rows of `row_bytes` each:
+  // one int64 per variable, or one bit per variable, least significant bit
+  // first, when every projected variable is boolean.
+  typedef struct
+  {
+    char magic[8];
+    uint32_t format;
+    uint32_t num_vars;
+    uint64_t row_bytes;
+    uint64_t num_rows;
+    uint64_t data_offset;
+  } SolutionFileHeader;
+
+  // A solution file mapped into memory.
+  typedef struct
+  {
+    const unsigned char *data;
+    size_t size;
+  } SolutionFileWrapper;
+
+  int load_solution_file(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
+
+  ERL_NIF_TERM enumerate_to_file_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM open_solution_file_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+  ERL_NIF_TERM read_solution_rows_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+}
+
+#endif
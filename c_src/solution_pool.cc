@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <vector>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/model.h"
+#include "ortools/sat/sat_parameters.pb.h"
+#include "wrappers.h"
+#include "cp_model_builder.h"
+#include "cp_solver_response.h"
+#include "log_stream.h"
+#include "native_memory.h"
+#include "solution_pool.h"
+#include "solve_options.h"
+#include "utility.h"
+#include "core/solution.h"
+#include "decode.h"
+
+using operations_research::sat::ConstraintProto;
+using operations_research::sat::CpModelProto;
+using operations_research::sat::CpSolverResponse;
+using operations_research::sat::IntegerVariableProto;
+using operations_research::sat::LinearConstraintProto;
+using operations_research::sat::Model;
+using operations_research::sat::NewFeasibleSolutionObserver;
+using operations_research::sat::NewSatParameters;
+using operations_research::sat::SatParameters;
+
+using namespace std;
+
+// Keep the k best solutions of a model that differ from each other in at least
+// a minimum number of the chosen variables.
+//
+// The improving solutions found by one solve are kept as rows of the chosen
+// variables' values and picked best first, skipping any too close to a picked
+// one. When that leaves fewer than k, the model is solved again with, for each
+// picked solution, a constraint that the next one differs from it in enough
+// variables, until k are found or no other solution exists.
+
+extern "C"
+{
+  static ERL_NIF_TERM atom_k;
+  static ERL_NIF_TERM atom_min_distance;
+  static ERL_NIF_TERM atom_resolve;
+  static ERL_NIF_TERM atom_true;
+  static ERL_NIF_TERM atom_false;
+
+  typedef struct
+  {
+    unsigned int k;
+    unsigned int min_distance;
+    bool resolve;
+  } PoolOptions;
+
+  static int init_atoms(ErlNifEnv *env)
+  {
+    atom_k = enif_make_atom(env, "k");
+    atom_min_distance = enif_make_atom(env, "min_distance");
+    atom_resolve = enif_make_atom(env, "resolve");
+    atom_true = enif_make_atom(env, "true");
+    atom_false = enif_make_atom(env, "false");
+    return 0;
+  }
+
+  static int get_pool_options(ErlNifEnv *env, ERL_NIF_TERM term, PoolOptions *options)
+  {
+    ERL_NIF_TERM value;
+
+    options->k = 5;
+    options->min_distance = 1;
+    options->resolve = true;
+
+    if (enif_get_map_value(env, term, atom_k, &value) &&
+        (!enif_get_uint(env, value, &options->k) || options->k == 0))
+    {
+      return 0;
+    }
+
+    if (enif_get_map_value(env, term, atom_min_distance, &value) &&
+        !enif_get_uint(env, value, &options->min_distance))
+    {
+      return 0;
+    }
+
+    if (enif_get_map_value(env, term, atom_resolve, &value))
+    {
+      if (!enif_is_identical(value, atom_true) && !enif_is_identical(value, atom_false))
+      {
+        return 0;
+      }
+      options->resolve = enif_is_identical(value, atom_true);
+    }
+
+    return 1;
+  }
+
+  // Solutions stored as rows of the values of the chosen variables.
+  class SolutionPool
+  {
+  public:
+    SolutionPool(const vector<int> &vars, bool maximize)
+        : vars_(vars), maximize_(maximize)
+    {
+    }
+
+    void Add(const CpSolverResponse &response)
+    {
+      lock_guard<mutex> lock(mutex_);
+      size_t offset = values_.size();
+      values_.resize(offset + vars_.size());
+      extract_int64_row(response, vars_.data(), vars_.size(), values_.data() + offset);
+      objectives_.push_back(response.objective_value());
+    }
+
+    size_t Size() const { return objectives_.size(); }
+    double Objective(size_t i) const { return objectives_[i]; }
+    const int64_t *Values(size_t i) const { return &values_[i * vars_.size()]; }
+
+    unsigned int Distance(size_t a, size_t b) const
+    {
+      unsigned int distance = 0;
+      for (size_t i = 0; i < vars_.size(); ++i)
+      {
+        if (Values(a)[i] != Values(b)[i])
+        {
+          ++distance;
+        }
+      }
+      return distance;
+    }
+
+    // Pick up to `k` solutions, best first, that are all at least
+    // `min_distance` apart.
+    vector<size_t> Pick(unsigned int k, unsigned int min_distance) const
+    {
+      vector<size_t> order(Size());
+      iota(order.begin(), order.end(), 0);
+
+      // Of equal solutions, the one found last was found with the best bound.
+      stable_sort(order.begin(), order.end(), [this](size_t a, size_t b)
+                  {
+                    if (objectives_[a] != objectives_[b])
+                    {
+                      return maximize_ ? objectives_[a] > objectives_[b] : objectives_[a] < objectives_[b];
+                    }
+                    return a > b; });
+
+      vector<size_t> picked;
+      for (size_t candidate : order)
+      {
+        if (picked.size() == k)
+        {
+          break;
+        }
+
+        bool distinct = true;
+        for (size_t other : picked)
+        {
+          if (Distance(candidate, other) < max(min_distance, 1u))
+          {
+            distinct = false;
+            break;
+          }
+        }
+
+        if (distinct)
+        {
+          picked.push_back(candidate);
+        }
+      }
+
+      return picked;
+    }
+
+  private:
+    const vector<int> &vars_;
+    bool maximize_;
+    mutex mutex_;
+    vector<int64_t> values_;
+    vector<double> objectives_;
+  };
+
+  static bool has_solution(const CpSolverResponse &response)
+  {
+    return response.status() == operations_research::sat::FEASIBLE ||
+           response.status() == operations_research::sat::OPTIMAL;
+  }
+
+  // Constrain the solutions of `model` to differ from `values` in at least
+  // `distance` of `vars`. A boolean contributes its literal or its negation
+  // directly, any other variable through a new boolean that is true exactly
+  // when the variable changes its value.
+  static void add_distance_constraint(CpModelProto *model, const vector<int> &vars, const int64_t *values, unsigned int distance)
+  {
+    LinearConstraintProto *differing = model->add_constraints()->mutable_linear();
+    int64_t ones = 0;
+
+    for (size_t i = 0; i < vars.size(); ++i)
+    {
+      int var = vars[i];
+
+      if (is_boolean_var(*model, var))
+      {
+        differing->add_vars(var);
+        differing->add_coeffs(values[i] ? -1 : 1);
+        ones += values[i] ? 1 : 0;
+        continue;
+      }
+
+      int changed = model->variables_size();
+      IntegerVariableProto *changed_var = model->add_variables();
+      changed_var->add_domain(0);
+      changed_var->add_domain(1);
+
+      ConstraintProto *same = model->add_constraints();
+      same->add_enforcement_literal(-changed - 1);
+      same->mutable_linear()->add_vars(var);
+      same->mutable_linear()->add_coeffs(1);
+      same->mutable_linear()->add_domain(values[i]);
+      same->mutable_linear()->add_domain(values[i]);
+
+      ConstraintProto *different = model->add_constraints();
+      different->add_enforcement_literal(changed);
+      different->mutable_linear()->add_vars(var);
+      different->mutable_linear()->add_coeffs(1);
+      if (values[i] > INT64_MIN)
+      {
+        different->mutable_linear()->add_domain(INT64_MIN);
+        different->mutable_linear()->add_domain(values[i] - 1);
+      }
+      if (values[i] < INT64_MAX)
+      {
+        different->mutable_linear()->add_domain(values[i] + 1);
+        different->mutable_linear()->add_domain(INT64_MAX);
+      }
+
+      differing->add_vars(changed);
+      differing->add_coeffs(1);
+    }
+
+    differing->add_domain((int64_t)distance - ones);
+    differing->add_domain(INT64_MAX);
+  }
+
+  // solution_pool_nif(builder, vars, options) returns the response of the
+  // first solve with a `pool` of `%{"objective" => _, "values" => [_]}`, best
+  // first.
+  ERL_NIF_TERM solution_pool_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+  {
+    BuilderWrapper *builder_wrapper;
+    vector<int> vars;
+    SolveOptions options;
+    PoolOptions pool_options;
+
+    if (!decode(env, argv[0], &builder_wrapper))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!decode_var_indexes(env, argv[1], builder_wrapper->p->Proto().variables_size(), &vars))
+    {
+      return enif_make_badarg(env);
+    }
+
+    if (!get_solve_options(env, argv[2], &options) ||
+        !get_pool_options(env, argv[2], &pool_options))
+    {
+      return enif_make_badarg(env);
+    }
+
+    CpModelProto model = builder_wrapper->p->Build();
+    track_native_memory(BUILDER_MEMORY, &builder_wrapper->bytes, model.SpaceUsedLong());
+
+    // A maximization is stored with a negative scaling factor.
+    bool maximize = model.objective().scaling_factor() < 0;
+    SolutionPool pool(vars, maximize);
+
+    Model solver;
+    SatParameters parameters;
+    apply_solve_options(options, &parameters);
+    solver.Add(NewSatParameters(parameters));
+    solver.Add(NewFeasibleSolutionObserver([&pool](const CpSolverResponse &r)
+                                           { pool.Add(r); }));
+    unique_ptr<LogStream> log_stream = attach_log_stream(env, options, &solver);
+
+    CpSolverResponse response = SolveCpModel(model, &solver);
+    log_stream.reset();
+
+    vector<size_t> picked = pool.Pick(pool_options.k, pool_options.min_distance);
+
+    if (pool_options.resolve && has_solution(response))
+    {
+      for (size_t i : picked)
+      {
+        add_distance_constraint(&model, vars, pool.Values(i), max(pool_options.min_distance, 1u));
+      }
+
+      while (picked.size() < pool_options.k)
+      {
+        Model resolver;
+        SatParameters resolve_parameters;
+        apply_solve_options(options, &resolve_parameters);
+        resolver.Add(NewSatParameters(resolve_parameters));
+        unique_ptr<LogStream> resolve_log_stream = attach_log_stream(env, options, &resolver);
+
+        CpSolverResponse alternative = SolveCpModel(model, &resolver);
+        if (!has_solution(alternative))
+        {
+          break;
+        }
+
+        pool.Add(alternative);
+        picked.push_back(pool.Size() - 1);
+        add_distance_constraint(&model, vars, pool.Values(pool.Size() - 1), max(pool_options.min_distance, 1u));
+      }
+
+      // The re-solved alternatives are no better than the solutions picked
+      // before them, but keep the pool in objective order regardless.
+      stable_sort(picked.begin(), picked.end(), [&pool, maximize](size_t a, size_t b)
+                  { return maximize ? pool.Objective(a) > pool.Objective(b) : pool.Objective(a) < pool.Objective(b); });
+    }
+
+    vector<ERL_NIF_TERM> solutions;
+    for (size_t i : picked)
+    {
+      vector<ERL_NIF_TERM> values;
+      for (size_t j = 0; j < vars.size(); ++j)
+      {
+        values.push_back(enif_make_int64(env, pool.Values(i)[j]));
+      }
+
+      ERL_NIF_TERM solution = enif_make_new_map(env);
+      solution = put_map_value(env, solution, "objective", enif_make_double(env, pool.Objective(i)));
+      solution = put_map_value(env, solution, "values", enif_make_list_from_array(env, values.data(), values.size()));
+      solutions.push_back(solution);
+    }
+
+    ERL_NIF_TERM result = make_cp_solver_response(env, response);
+    result = put_map_value(env, result, "pool", enif_make_list_from_array(env, solutions.data(), solutions.size()));
+
+    return result;
+  }
+
+  int load_solution_pool(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
+  {
+    if (init_atoms(env) == -1)
+      return -1;
+    else
+      return 0;
+  }
+}
@@ -0,0 +1,13 @@
+#ifndef __SOLUTION_POOL_H__
+#define __SOLUTION_POOL_H__
+
+#include "erl_nif.h"
+
+extern "C"
+{
+  int load_solution_pool(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
+
+  ERL_NIF_TERM solution_pool_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+}
+
+#endif
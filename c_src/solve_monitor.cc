@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cmath>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/model.h"
+#include "ortools/util/time_limit.h"
+#include "native_memory.h"
+#include "solve_monitor.h"
+#include "utility.h"
+
+using operations_research::TimeLimit;
+using operations_research::sat::CpModelProto;
+using operations_research::sat::CpSolverResponse;
+using operations_research::sat::Model;
+using operations_research::sat::NewBestBoundCallback;
+using operations_research::sat::NewFeasibleSolutionObserver;
+
+using namespace std;
+
+SolveMonitor::SolveMonitor(const SolveOptions &options, size_t model_bytes)
+    : options_(options),
+      started_at_(Clock::now()),
+      stop_(false),
+      stopped_for_no_improvement_(false),
+      stopped_for_memory_(false),
+      model_bytes_(model_bytes),
+      started_rss_(process_resident_bytes()),
+      finished_(false),
+      has_objective_(false),
+      objective_(0),
+      has_bound_(false),
+      best_bound_(0),
+      changed_(false),
+      improved_at_(started_at_),
+      msg_env_(NULL)
+{
+}
+
+SolveMonitor::~SolveMonitor()
+{
+  Finish();
+  if (msg_env_ != NULL)
+  {
+    enif_free_env(msg_env_);
+  }
+}
+
+void SolveMonitor::Attach(Model *model)
+{
+  model->GetOrCreate<TimeLimit>()->RegisterExternalBooleanAsLimit(&stop_);
+  model->Add(NewFeasibleSolutionObserver([this](const CpSolverResponse &r)
+                                         { OnSolution(r); }));
+  model->Add(NewBestBoundCallback([this](double bound)
+                                  { OnBound(bound); }));
+
+  if (options_.has_progress_pid || options_.no_improvement_timeout > 0 || options_.max_memory_in_mb > 0)
+  {
+    msg_env_ = enif_alloc_env();
+    watcher_ = thread(&SolveMonitor::Watch, this);
+  }
+}
+
+void SolveMonitor::Finish()
+{
+  {
+    lock_guard<mutex> lock(mutex_);
+    finished_ = true;
+  }
+  finished_cv_.notify_all();
+
+  if (watcher_.joinable())
+  {
+    watcher_.join();
+  }
+}
+
+const char *SolveMonitor::StopReason(const CpSolverResponse &response) const
+{
+  if (stopped_for_memory_)
+  {
+    return "memory_limit";
+  }
+
+  if (stopped_for_no_improvement_)
+  {
+    return "no_improvement";
+  }
+
+  bool gap_limited = options_.relative_gap_limit >= 0 || options_.absolute_gap_limit >= 0;
+  if (gap_limited &&
+      response.status() == operations_research::sat::OPTIMAL &&
+      fabs(response.objective_value() - response.best_objective_bound()) > 1e-9)
+  {
+    return "gap_limit";
+  }
+
+  return NULL;
+}
+
+void SolveMonitor::OnSolution(const CpSolverResponse &response)
+{
+  lock_guard<mutex> lock(mutex_);
+  has_objective_ = true;
+  objective_ = response.objective_value();
+  improved_at_ = Clock::now();
+  changed_ = true;
+}
+
+void SolveMonitor::OnBound(double bound)
+{
+  lock_guard<mutex> lock(mutex_);
+  has_bound_ = true;
+  best_bound_ = bound;
+  changed_ = true;
+}
+
+void SolveMonitor::Watch()
+{
+  chrono::milliseconds tick(options_.has_progress_pid ? max(options_.progress_interval, 1u) : 100u);
+  if (options_.no_improvement_timeout > 0 || options_.max_memory_in_mb > 0)
+  {
+    tick = min(tick, chrono::milliseconds(100));
+  }
+
+  chrono::milliseconds progress_interval(options_.progress_interval);
+  chrono::duration<double> no_improvement_timeout(options_.no_improvement_timeout);
+  Clock::time_point progress_sent_at = started_at_;
+
+  unique_lock<mutex> lock(mutex_);
+  while (!finished_cv_.wait_for(lock, tick, [this]
+                                { return finished_; }))
+  {
+    Clock::time_point now = Clock::now();
+
+    if (options_.no_improvement_timeout > 0 && now - improved_at_ >= no_improvement_timeout)
+    {
+      stopped_for_no_improvement_ = true;
+      stop_ = true;
+    }
+
+    if (options_.max_memory_in_mb > 0 && !stop_ && OverMemoryBudget())
+    {
+      stopped_for_memory_ = true;
+      stop_ = true;
+    }
+
+    if (options_.has_progress_pid && changed_ && now - progress_sent_at >= progress_interval)
+    {
+      SendProgress();
+      progress_sent_at = now;
+      changed_ = false;
+    }
+  }
+
+  // Report the last change, which a solve shorter than a tick never reports.
+  if (options_.has_progress_pid && changed_)
+  {
+    SendProgress();
+  }
+}
+
+bool SolveMonitor::OverMemoryBudget() const
+{
+  size_t rss = process_resident_bytes();
+  size_t used = model_bytes_ + (rss > started_rss_ ? rss - started_rss_ : 0);
+
+  return used > (size_t)options_.max_memory_in_mb * 1024 * 1024;
+}
+
+// Called by the watcher thread with `mutex_` held.
+void SolveMonitor::SendProgress()
+{
+  chrono::duration<double> walltime = Clock::now() - started_at_;
+
+  ERL_NIF_TERM keys[] = {
+      make_binary_key(msg_env_, "objective"),
+      make_binary_key(msg_env_, "best_bound"),
+      make_binary_key(msg_env_, "walltime")};
+  ERL_NIF_TERM values[] = {
+      has_objective_ ? enif_make_double(msg_env_, objective_) : enif_make_atom(msg_env_, "nil"),
+      has_bound_ ? enif_make_double(msg_env_, best_bound_) : enif_make_atom(msg_env_, "nil"),
+      enif_make_double(msg_env_, walltime.count())};
+
+  ERL_NIF_TERM progress;
+  enif_make_map_from_arrays(msg_env_, keys, values, 3, &progress);
+  ERL_NIF_TERM msg = enif_make_tuple2(msg_env_, enif_make_atom(msg_env_, "exhort_progress"), progress);
+
+  enif_send(NULL, &options_.progress_pid, msg_env_, msg);
+  enif_clear_env(msg_env_);
+}
+
+unique_ptr<SolveMonitor> attach_solve_monitor(const SolveOptions &options, const CpModelProto &proto, Model *model)
+{
+  if (!options.has_progress_pid &&
+      options.no_improvement_timeout <= 0 &&
+      options.max_memory_in_mb == 0 &&
+      options.relative_gap_limit < 0 &&
+      options.absolute_gap_limit < 0)
+  {
+    return nullptr;
+  }
+
+  size_t model_bytes = options.max_memory_in_mb > 0 ? proto.SpaceUsedLong() : 0;
+  unique_ptr<SolveMonitor> monitor(new SolveMonitor(options, model_bytes));
+  monitor->Attach(model);
+
+  return monitor;
+}
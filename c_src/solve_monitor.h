@@ -0,0 +1,86 @@
+#ifndef __SOLVE_MONITOR_H__
+#define __SOLVE_MONITOR_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "erl_nif.h"
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/model.h"
+#include "solve_options.h"
+
+using operations_research::sat::CpModelProto;
+using operations_research::sat::CpSolverResponse;
+using operations_research::sat::Model;
+
+// Watch a running solve on behalf of the solve options that need to observe
+// the search: progress reporting, the no-improvement timeout and the memory
+// budget.
+//
+// The incumbent objective and the best bound are recorded from the solver's
+// callbacks. A watcher thread wakes periodically to send
+// `{:exhort_progress, %{"objective" => _, "best_bound" => _, "walltime" => _}}`
+// and to stop the search, through an external limit registered with the
+// solver, once no improving solution has been found for too long or once the
+// solve has outgrown its memory budget.
+//
+// CP-SAT checks `max_memory_in_mb` itself, but only against the memory of the
+// whole process, which includes the VM. The budget is therefore not passed to
+// CP-SAT: the monitor alone charges the solve with the resident memory it
+// added since it started plus the size of the model. A solve that CP-SAT ends
+// without a proof while over the budget, e.g. at its own default limit, is
+// also reported as stopped for memory.
+class SolveMonitor
+{
+public:
+  SolveMonitor(const SolveOptions &options, size_t model_bytes);
+  ~SolveMonitor();
+
+  // Register the callbacks and the stop flag with `model` and start watching.
+  void Attach(Model *model);
+
+  // Stop watching. Called once the solve has returned.
+  void Finish();
+
+  // Why the search stopped before proving optimality, or NULL.
+  const char *StopReason(const CpSolverResponse &response) const;
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  void OnSolution(const CpSolverResponse &response);
+  void OnBound(double bound);
+  void Watch();
+  void SendProgress();
+  bool OverMemoryBudget() const;
+
+  SolveOptions options_;
+  Clock::time_point started_at_;
+  std::atomic<bool> stop_;
+  std::atomic<bool> stopped_for_no_improvement_;
+  std::atomic<bool> stopped_for_memory_;
+  size_t model_bytes_;
+  size_t started_rss_;
+
+  std::mutex mutex_;
+  std::condition_variable finished_cv_;
+  bool finished_;
+  bool has_objective_;
+  double objective_;
+  bool has_bound_;
+  double best_bound_;
+  bool changed_;
+  Clock::time_point improved_at_;
+
+  ErlNifEnv *msg_env_;
+  std::thread watcher_;
+};
+
+// Monitor the solve of `model` when `options` call for it. Returns NULL when
+// no monitoring is needed, so a plain solve carries no extra callbacks.
+std::unique_ptr<SolveMonitor> attach_solve_monitor(const SolveOptions &options, const CpModelProto &proto, Model *model);
+
+#endif
@@ -0,0 +1,243 @@
+#include <cstring>
+#include "erl_nif.h"
+#include "ortools/sat/sat_parameters.pb.h"
+#include "probes.h"
+#include "solve_options.h"
+
+using operations_research::sat::SatParameters;
+
+extern "C"
+{
+  static ERL_NIF_TERM atom_log;
+  static ERL_NIF_TERM atom_log_max_lines;
+  static ERL_NIF_TERM atom_log_max_bytes;
+  static ERL_NIF_TERM atom_log_flush_interval;
+  static ERL_NIF_TERM atom_progress;
+  static ERL_NIF_TERM atom_progress_interval;
+  static ERL_NIF_TERM atom_relative_gap_limit;
+  static ERL_NIF_TERM atom_absolute_gap_limit;
+  static ERL_NIF_TERM atom_no_improvement_timeout;
+  static ERL_NIF_TERM atom_max_memory_in_mb;
+  static ERL_NIF_TERM atom_time_limit;
+  static ERL_NIF_TERM atom_deterministic;
+  static ERL_NIF_TERM atom_seed;
+  static ERL_NIF_TERM atom_num_workers;
+  static ERL_NIF_TERM atom_deterministic_time_limit;
+  static ERL_NIF_TERM atom_true;
+  static ERL_NIF_TERM atom_false;
+
+  static int init_atoms(ErlNifEnv *env)
+  {
+    atom_log = enif_make_atom(env, "log");
+    atom_log_max_lines = enif_make_atom(env, "log_max_lines");
+    atom_log_max_bytes = enif_make_atom(env, "log_max_bytes");
+    atom_log_flush_interval = enif_make_atom(env, "log_flush_interval");
+    atom_progress = enif_make_atom(env, "progress");
+    atom_progress_interval = enif_make_atom(env, "progress_interval");
+    atom_relative_gap_limit = enif_make_atom(env, "relative_gap_limit");
+    atom_absolute_gap_limit = enif_make_atom(env, "absolute_gap_limit");
+    atom_no_improvement_timeout = enif_make_atom(env, "no_improvement_timeout");
+    atom_max_memory_in_mb = enif_make_atom(env, "max_memory_in_mb");
+    atom_time_limit = enif_make_atom(env, "time_limit");
+    atom_deterministic = enif_make_atom(env, "deterministic");
+    atom_seed = enif_make_atom(env, "seed");
+    atom_num_workers = enif_make_atom(env, "num_workers");
+    atom_deterministic_time_limit = enif_make_atom(env, "deterministic_time_limit");
+    atom_true = enif_make_atom(env, "true");
+    atom_false = enif_make_atom(env, "false");
+    return 0;
+  }
+
+  static int get_uint_option(ErlNifEnv *env, ERL_NIF_TERM map, ERL_NIF_TERM key, unsigned int *value)
+  {
+    ERL_NIF_TERM term;
+    if (!enif_get_map_value(env, map, key, &term))
+    {
+      return 1;
+    }
+
+    return enif_get_uint(env, term, value);
+  }
+
+  static int get_double_option(ErlNifEnv *env, ERL_NIF_TERM map, ERL_NIF_TERM key, double *value)
+  {
+    ERL_NIF_TERM term;
+    if (!enif_get_map_value(env, map, key, &term))
+    {
+      return 1;
+    }
+
+    if (enif_get_double(env, term, value))
+    {
+      return 1;
+    }
+
+    ErlNifSInt64 int_value;
+    if (!enif_get_int64(env, term, &int_value))
+    {
+      return 0;
+    }
+
+    *value = (double)int_value;
+    return 1;
+  }
+
+  static int get_bool_option(ErlNifEnv *env, ERL_NIF_TERM map, ERL_NIF_TERM key, bool *value)
+  {
+    ERL_NIF_TERM term;
+    if (!enif_get_map_value(env, map, key, &term))
+    {
+      return 1;
+    }
+
+    if (enif_is_identical(term, atom_true))
+    {
+      *value = true;
+      return 1;
+    }
+
+    if (enif_is_identical(term, atom_false))
+    {
+      *value = false;
+      return 1;
+    }
+
+    return 0;
+  }
+
+  static int get_pid_option(ErlNifEnv *env, ERL_NIF_TERM map, ERL_NIF_TERM key, bool *has_pid, ErlNifPid *pid)
+  {
+    ERL_NIF_TERM term;
+    if (!enif_get_map_value(env, map, key, &term))
+    {
+      return 1;
+    }
+
+    if (!enif_get_local_pid(env, term, pid))
+    {
+      return 0;
+    }
+
+    *has_pid = true;
+    return 1;
+  }
+
+  int get_solve_options(ErlNifEnv *env, ERL_NIF_TERM term, SolveOptions *options)
+  {
+    options->has_log_pid = false;
+    options->log_max_lines = 64;
+    options->log_max_bytes = 16 * 1024;
+    options->log_flush_interval = 250;
+    options->has_progress_pid = false;
+    options->progress_interval = 500;
+    options->relative_gap_limit = -1;
+    options->absolute_gap_limit = -1;
+    options->no_improvement_timeout = 0;
+    options->max_memory_in_mb = 0;
+    options->time_limit = 0;
+    options->deterministic = false;
+    options->seed = -1;
+    options->num_workers = 0;
+    options->deterministic_time_limit = 0;
+
+    if (!enif_is_map(env, term))
+    {
+      return 0;
+    }
+
+    if (!get_pid_option(env, term, atom_log, &options->has_log_pid, &options->log_pid) ||
+        !get_uint_option(env, term, atom_log_max_lines, &options->log_max_lines) ||
+        !get_uint_option(env, term, atom_log_max_bytes, &options->log_max_bytes) ||
+        !get_uint_option(env, term, atom_log_flush_interval, &options->log_flush_interval))
+    {
+      return 0;
+    }
+
+    if (!get_pid_option(env, term, atom_progress, &options->has_progress_pid, &options->progress_pid) ||
+        !get_uint_option(env, term, atom_progress_interval, &options->progress_interval) ||
+        !get_double_option(env, term, atom_relative_gap_limit, &options->relative_gap_limit) ||
+        !get_double_option(env, term, atom_absolute_gap_limit, &options->absolute_gap_limit) ||
+        !get_double_option(env, term, atom_no_improvement_timeout, &options->no_improvement_timeout))
+    {
+      return 0;
+    }
+
+    if (!get_uint_option(env, term, atom_max_memory_in_mb, &options->max_memory_in_mb) ||
+        !get_double_option(env, term, atom_time_limit, &options->time_limit))
+    {
+      return 0;
+    }
+
+    if (!get_bool_option(env, term, atom_deterministic, &options->deterministic) ||
+        !get_uint_option(env, term, atom_num_workers, &options->num_workers) ||
+        !get_double_option(env, term, atom_deterministic_time_limit, &options->deterministic_time_limit))
+    {
+      return 0;
+    }
+
+    ERL_NIF_TERM seed;
+    if (enif_get_map_value(env, term, atom_seed, &seed) &&
+        (!enif_get_int(env, seed, &options->seed) || options->seed < 0))
+    {
+      return 0;
+    }
+
+    return 1;
+  }
+
+  void apply_solve_options(const SolveOptions &options, SatParameters *parameters)
+  {
+    // The worker stats of a deterministic solve and the end of presolve for
+    // the solve probes are read from the log.
+    if (options.has_log_pid || options.deterministic || solve_probes_enabled())
+    {
+      parameters->set_log_search_progress(true);
+      parameters->set_log_to_stdout(false);
+    }
+
+    if (options.relative_gap_limit >= 0)
+    {
+      parameters->set_relative_gap_limit(options.relative_gap_limit);
+    }
+
+    if (options.absolute_gap_limit >= 0)
+    {
+      parameters->set_absolute_gap_limit(options.absolute_gap_limit);
+    }
+
+    if (options.time_limit > 0)
+    {
+      parameters->set_max_time_in_seconds(options.time_limit);
+    }
+
+    if (options.deterministic)
+    {
+      // The interleaved schedule depends on the number of workers, so it is
+      // pinned rather than taken from the host's core count.
+      parameters->set_interleave_search(true);
+      parameters->set_num_workers(options.num_workers > 0 ? options.num_workers : 8);
+    }
+    else if (options.num_workers > 0)
+    {
+      parameters->set_num_workers(options.num_workers);
+    }
+
+    if (options.seed >= 0)
+    {
+      parameters->set_random_seed(options.seed);
+    }
+
+    if (options.deterministic_time_limit > 0)
+    {
+      parameters->set_max_deterministic_time(options.deterministic_time_limit);
+    }
+  }
+
+  int load_solve_options(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
+  {
+    if (init_atoms(env) == -1)
+      return -1;
+    else
+      return 0;
+  }
+}
@@ -0,0 +1,72 @@
+#ifndef __SOLVE_OPTIONS_H__
+#define __SOLVE_OPTIONS_H__
+
+#include "erl_nif.h"
+#include "ortools/sat/sat_parameters.pb.h"
+
+using operations_research::sat::SatParameters;
+
+extern "C"
+{
+  // Options for a single solve, decoded from the map given to the solve NIFs.
+  // Every option is off by default so a solve without options behaves exactly
+  // as it did before options existed.
+  typedef struct
+  {
+    // Stream the search log to `log_pid`.
+    bool has_log_pid;
+    ErlNifPid log_pid;
+
+    // Upper bounds on the log lines and bytes buffered before they are sent.
+    unsigned int log_max_lines;
+    unsigned int log_max_bytes;
+
+    // Longest time, in milliseconds, a buffered line waits before it is sent.
+    unsigned int log_flush_interval;
+
+    // Send objective and bound progress to `progress_pid` every
+    // `progress_interval` milliseconds.
+    bool has_progress_pid;
+    ErlNifPid progress_pid;
+    unsigned int progress_interval;
+
+    // Stop once the gap between the objective and the best bound is within
+    // these limits. Negative when not set.
+    double relative_gap_limit;
+    double absolute_gap_limit;
+
+    // Stop when no improving solution is found for this many seconds. Zero
+    // when not set.
+    double no_improvement_timeout;
+
+    // Stop once the solve uses more than this many megabytes: the growth of
+    // the process' resident memory plus the size of the model. Enforced by
+    // the solve monitor only, not passed to CP-SAT. Zero when not set.
+    unsigned int max_memory_in_mb;
+
+    // Stop the search after this many seconds. Zero when not set.
+    double time_limit;
+
+    // Search with interleaved workers, so repeated solves of the same model
+    // with the same seed and worker count follow the same search, and report
+    // the time spent by each worker.
+    bool deterministic;
+
+    // The solver's random seed. Negative when not set.
+    int seed;
+
+    // The number of search workers. Zero when not set.
+    unsigned int num_workers;
+
+    // Stop the search after this much deterministic time. Zero when not set.
+    double deterministic_time_limit;
+  } SolveOptions;
+
+  int load_solve_options(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info);
+
+  int get_solve_options(ErlNifEnv *env, ERL_NIF_TERM term, SolveOptions *options);
+
+  void apply_solve_options(const SolveOptions &options, SatParameters *parameters);
+}
+
+#endif
@@ -2,81 +2,63 @@
 #include <iostream>
 #include "erl_nif.h"
 #include "wrappers.h"
+#include "bool_var.h"
 #include "int_var.h"
+#include "utility.h"
+#include "decode.h"
 
 using namespace std;
 
 extern "C"
 {
-  int get_int_list(ErlNifEnv *env, ERL_NIF_TERM term, vector<int64_t> **vars)
+  int get_int_list(ErlNifEnv *env, ERL_NIF_TERM term, vector<int64_t> *values)
   {
-    unsigned int list_length;
-    if (!enif_get_list_length(env, term, &list_length))
-    {
-      return enif_make_badarg(env);
-    }
-
-    vector<int64_t> *list = new vector<int64_t>();
-
-    ERL_NIF_TERM head;
-    ERL_NIF_TERM tail;
-    ERL_NIF_TERM current = term;
-    for (int i = 0; i < list_length; ++i)
-    {
-      if (!enif_get_list_cell(env, current, &head, &tail))
-      {
-        return enif_make_badarg(env);
-      }
-
-      long var;
-      if (!enif_get_long(env, head, &var))
-      {
-        return enif_make_badarg(env);
-      }
-
-      list->push_back(var);
-
-      current = tail;
-    }
-
-    *vars = list;
+    return decode(env, term, values);
+  }
 
-    return 1;
+  int get_int_var_list(ErlNifEnv *env, ERL_NIF_TERM term, vector<IntVar> *vars)
+  {
+    return decode(env, term, vars);
   }
 
-  int get_int_var_list(ErlNifEnv *env, ERL_NIF_TERM term, vector<IntVar> **vars)
+  // Get the index of the model variable behind an integer or boolean variable.
+  // A negated boolean refers to the same variable as its positive literal.
+  int get_var_index(ErlNifEnv *env, ERL_NIF_TERM term, int *index)
   {
-    unsigned int list_length;
-    if (!enif_get_list_length(env, term, &list_length))
+    IntVarWrapper *int_var;
+    if (decode(env, term, &int_var))
     {
-      return enif_make_badarg(env);
+      *index = int_var->p->index();
+      return 1;
     }
 
-    vector<IntVar> *list = new vector<IntVar>();
-
-    ERL_NIF_TERM head;
-    ERL_NIF_TERM tail;
-    ERL_NIF_TERM current = term;
-    for (int i = 0; i < list_length; ++i)
+    BoolVarWrapper *bool_var;
+    if (decode(env, term, &bool_var))
     {
-      if (!enif_get_list_cell(env, current, &head, &tail))
-      {
-        return enif_make_badarg(env);
-      }
+      int ref = bool_var->p->index();
+      *index = ref >= 0 ? ref : -ref - 1;
+      return 1;
+    }
 
-      IntVarWrapper *var;
-      if (!get_int_var(env, head, &var))
-      {
-        return enif_make_badarg(env);
-      }
+    return 0;
+  }
 
-      list->push_back(*var->p);
+  ERL_NIF_TERM make_binary_key(ErlNifEnv *env, const char *key)
+  {
+    ERL_NIF_TERM term;
+    size_t size = strlen(key);
+    memcpy(enif_make_new_binary(env, size, &term), key, size);
+    return term;
+  }
 
-      current = tail;
+  ERL_NIF_TERM put_map_value(ErlNifEnv *env, ERL_NIF_TERM map, const char *key, ERL_NIF_TERM value)
+  {
+    ERL_NIF_TERM result;
+    if (!enif_make_map_put(env, map, make_binary_key(env, key), value, &result))
+    {
+      return map;
     }
 
-    *vars = list;
-
-    return 1;
+    return result;
   }
 }
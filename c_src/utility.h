@@ -3,14 +3,27 @@
 
 #include <vector>
 #include "erl_nif.h"
+#include "wrappers.h"
+#include "core/model_assembly.h"
 
 using namespace std;
 
 extern "C"
 {
-  int get_int_list(ErlNifEnv *env, ERL_NIF_TERM term, vector<int64_t> **vars);
+  // Append the integers of a list to `values`.
+  int get_int_list(ErlNifEnv *env, ERL_NIF_TERM term, vector<int64_t> *values);
 
-  int get_int_var_list(ErlNifEnv *env, ERL_NIF_TERM term, vector<IntVar> **vars);
+  // Append the variables of a list of `IntVar` resources to `vars`.
+  int get_int_var_list(ErlNifEnv *env, ERL_NIF_TERM term, vector<IntVar> *vars);
+
+  int get_var_index(ErlNifEnv *env, ERL_NIF_TERM term, int *index);
+
+  // Make a binary term of the C string `key`, e.g. for a map key.
+  ERL_NIF_TERM make_binary_key(ErlNifEnv *env, const char *key);
+
+  // Put `value` under the binary `key` in `map`. Returns `map` unchanged when
+  // it is not a map.
+  ERL_NIF_TERM put_map_value(ErlNifEnv *env, ERL_NIF_TERM map, const char *key, ERL_NIF_TERM value);
 }
 
 #endif
@@ -0,0 +1,175 @@
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include "erl_nif.h"
+#include "ortools/sat/model.h"
+#include "ortools/util/logging.h"
+#include "cp_solver_response.h"
+#include "worker_stats.h"
+#include "utility.h"
+
+using operations_research::SolverLogger;
+
+using namespace std;
+
+// Parse a duration as formatted in the log, e.g. "1.25s", "350.10ms" or
+// "2m3.5s", into seconds.
+static double parse_duration(const string &text)
+{
+  const char *current = text.c_str();
+  double seconds = 0;
+
+  while (*current != '\0')
+  {
+    char *end;
+    double value = strtod(current, &end);
+    if (end == current)
+    {
+      break;
+    }
+
+    if (strncmp(end, "ns", 2) == 0)
+    {
+      seconds += value * 1e-9;
+      current = end + 2;
+    }
+    else if (strncmp(end, "us", 2) == 0)
+    {
+      seconds += value * 1e-6;
+      current = end + 2;
+    }
+    else if (strncmp(end, "ms", 2) == 0)
+    {
+      seconds += value * 1e-3;
+      current = end + 2;
+    }
+    else if (*end == 'h')
+    {
+      seconds += value * 3600;
+      current = end + 1;
+    }
+    else if (*end == 'm')
+    {
+      seconds += value * 60;
+      current = end + 1;
+    }
+    else if (*end == 's')
+    {
+      seconds += value;
+      current = end + 1;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  return seconds;
+}
+
+WorkerStats::WorkerStats()
+    : in_task_timing_(false)
+{
+}
+
+void WorkerStats::Append(const string &message)
+{
+  lock_guard<mutex> lock(mutex_);
+
+  // A table is logged as a single message.
+  istringstream lines(message);
+  string line;
+  while (getline(lines, line))
+  {
+    AppendLine(line);
+  }
+}
+
+// A row is `'name': n [min, max] avg dev time n [min, max] avg dev dtime`.
+void WorkerStats::AppendLine(const string &line)
+{
+  if (line.compare(0, 11, "Task timing") == 0)
+  {
+    in_task_timing_ = true;
+    workers_.clear();
+    return;
+  }
+
+  if (!in_task_timing_)
+  {
+    return;
+  }
+
+  size_t name_start = line.find('\'');
+  size_t name_end = name_start == string::npos ? string::npos : line.find("':", name_start + 1);
+  if (name_end == string::npos)
+  {
+    in_task_timing_ = false;
+    return;
+  }
+
+  string columns = line.substr(name_end + 2);
+  for (char &c : columns)
+  {
+    if (c == '[' || c == ']' || c == ',')
+    {
+      c = ' ';
+    }
+  }
+
+  vector<string> fields;
+  istringstream tokens(columns);
+  string token;
+  while (tokens >> token)
+  {
+    fields.push_back(token);
+  }
+
+  if (fields.size() < 6)
+  {
+    return;
+  }
+
+  Worker worker;
+  worker.name = line.substr(name_start + 1, name_end - name_start - 1);
+  worker.tasks = atol(fields[0].c_str());
+  worker.walltime = parse_duration(fields[5]);
+  worker.deterministic_time = fields.size() >= 12 ? parse_duration(fields[11]) : 0;
+  workers_.push_back(worker);
+}
+
+ERL_NIF_TERM WorkerStats::MakeTerm(ErlNifEnv *env)
+{
+  lock_guard<mutex> lock(mutex_);
+
+  vector<ERL_NIF_TERM> workers;
+  for (const Worker &worker : workers_)
+  {
+    ERL_NIF_TERM name;
+    memcpy(enif_make_new_binary(env, worker.name.size(), &name), worker.name.data(), worker.name.size());
+
+    ERL_NIF_TERM term = enif_make_new_map(env);
+    term = put_map_value(env, term, "name", name);
+    term = put_map_value(env, term, "tasks", enif_make_long(env, worker.tasks));
+    term = put_map_value(env, term, "walltime", enif_make_double(env, worker.walltime));
+    term = put_map_value(env, term, "deterministic_time", enif_make_double(env, worker.deterministic_time));
+    workers.push_back(term);
+  }
+
+  return enif_make_list_from_array(env, workers.data(), workers.size());
+}
+
+unique_ptr<WorkerStats> attach_worker_stats(const SolveOptions &options, Model *model)
+{
+  if (!options.deterministic)
+  {
+    return nullptr;
+  }
+
+  unique_ptr<WorkerStats> stats(new WorkerStats());
+  WorkerStats *s = stats.get();
+  model->GetOrCreate<SolverLogger>()->AddInfoLoggingCallback([s](const string &message)
+                                                             { s->Append(message); });
+
+  return stats;
+}
@@ -0,0 +1,51 @@
+#ifndef __WORKER_STATS_H__
+#define __WORKER_STATS_H__
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "erl_nif.h"
+#include "ortools/sat/model.h"
+#include "solve_options.h"
+
+using operations_research::sat::Model;
+
+// Collect the time spent by each worker of a parallel solve.
+//
+// CP-SAT only reports the per-worker breakdown in the "Task timing" table of
+// its search log, so the log lines are read as they are written and the rows
+// of that table are kept: the number of tasks each worker ran, their wall time
+// and their deterministic time.
+class WorkerStats
+{
+public:
+  WorkerStats();
+
+  void Append(const std::string &message);
+
+  // Make `[%{"name" => _, "tasks" => _, "walltime" => _,
+  // "deterministic_time" => _}]`, in the order of the table.
+  ERL_NIF_TERM MakeTerm(ErlNifEnv *env);
+
+private:
+  typedef struct
+  {
+    std::string name;
+    long tasks;
+    double walltime;
+    double deterministic_time;
+  } Worker;
+
+  void AppendLine(const std::string &line);
+
+  std::mutex mutex_;
+  bool in_task_timing_;
+  std::vector<Worker> workers_;
+};
+
+// Collect the worker stats of the solve of `model` when `options` are
+// deterministic. Returns NULL otherwise.
+std::unique_ptr<WorkerStats> attach_worker_stats(const SolveOptions &options, Model *model);
+
+#endif
@@ -1,15 +1,20 @@
 #ifndef __WRAPPERS_H__
 #define __WRAPPERS_H__
 
+#include <atomic>
 #include "ortools/sat/cp_model.h"
 
 // Wrap each underlying model so the underlying model may be allocated
 // using its class constructor. Each underlying model is referenced
-// through the wrapper's `p` member.
+// through the wrapper's `p` member. Wrappers of objects that may grow large
+// also record the `bytes` last accounted for them in `native_memory.h`.
+// The memory of a resource is not constructed by `enif_alloc_resource`, so
+// atomic members are constructed in place with placement `new`.
 
 using operations_research::sat::BoolVar;
 using operations_research::sat::Constraint;
 using operations_research::sat::CpModelBuilder;
+using operations_research::sat::CpModelProto;
 using operations_research::sat::CpSolverResponse;
 using operations_research::sat::IntervalVar;
 using operations_research::sat::IntVar;
@@ -17,9 +22,19 @@ using operations_research::sat::LinearExpr;
 
 extern "C"
 {
+  // Each builder has a unique `id`. A builder started from another with
+  // `new_sub_builder_nif` records the `parent` it is merged back into, where
+  // its own variables and constraints begin, and whether it was `merged`. The
+  // parent and bases are 0 otherwise.
   typedef struct
   {
     CpModelBuilder *p;
+    std::atomic<size_t> bytes;
+    uint64_t id;
+    uint64_t parent;
+    int base_variables;
+    int base_constraints;
+    std::atomic<bool> merged;
   } BuilderWrapper;
 
   typedef struct
@@ -37,20 +52,29 @@ extern "C"
     IntervalVar *p;
   } IntervalVarWrapper;
 
+  // A constraint records the `id` of the builder it was added to.
   typedef struct
   {
     Constraint *p;
+    uint64_t builder;
   } ConstraintWrapper;
 
   typedef struct
   {
     CpSolverResponse *p;
+    std::atomic<size_t> bytes;
   } CpSolverResponseWrapper;
 
   typedef struct
   {
     LinearExpr *p;
   } LinearExprWrapper;
+
+  typedef struct
+  {
+    CpModelProto *p;
+    std::atomic<size_t> bytes;
+  } PresolvedModelWrapper;
 }
 
 #endif
@@ -0,0 +1,78 @@
+defmodule Exhort.NativeMemory do
+  @moduledoc """
+  Report the memory held by the native OR Tools objects.
+
+  This memory is allocated outside of the BEAM and so does not appear in
+  `:erlang.memory/0`.
+  """
+
+  alias Exhort.NIF.Nif
+
+  @type counters :: %{
+          live: integer(),
+          allocated: non_neg_integer(),
+          bytes: integer()
+        }
+
+  @type t :: %{
+          builders: integer(),
+          responses: integer(),
+          presolved: integer(),
+          rss: non_neg_integer()
+        }
+
+  @doc """
+  Return the memory, in bytes, currently held natively:
+
+  - `builders` - The models of the live builders, as measured when each was
+    last solved.
+  - `responses` - The live solver responses.
+  - `presolved` - The live presolved models.
+  - `rss` - The resident set size of the whole OS process, or 0 when it is not
+    known on this platform.
+  """
+  @spec report() :: t()
+  def report do
+    stats = Nif.native_memory_nif()
+
+    %{
+      builders: Map.get(stats, "builders"),
+      responses: Map.get(stats, "responses"),
+      presolved: Map.get(stats, "presolved"),
+      rss: Map.get(stats, "rss")
+    }
+  end
+
+  @doc """
+  Return the counters of the native resources, by kind: `builders`,
+  `bool_vars`, `int_vars`, `interval_vars`, `expressions`, `constraints`,
+  `responses`, `presolved` and `solution_files`.
+
+  For each kind:
+
+  - `live` - The resources not yet garbage collected.
+  - `allocated` - The resources allocated since the NIF library was loaded.
+  - `bytes` - The native memory held by the live resources, including the
+    models of builders, responses and presolved models as reported by
+    `report/0`.
+
+  The resources freed so far are `allocated - live`. A `live` count that keeps
+  growing while the number freed stays flat points at references held on the
+  Elixir side.
+
+  Compiling with `EXHORT_DEBUG=1` additionally writes the live resources to
+  stderr whenever a builder is freed.
+  """
+  @spec resources() :: %{atom() => counters()}
+  def resources do
+    Nif.native_resources_nif()
+    |> Map.new(fn {kind, counters} ->
+      {String.to_atom(kind),
+       %{
+         live: Map.get(counters, "live"),
+         allocated: Map.get(counters, "allocated"),
+         bytes: Map.get(counters, "bytes")
+       }}
+    end)
+  end
+end
@@ -18,6 +18,14 @@ defmodule Exhort.NIF.Nif do
     unimplemented().on_unimplemented()
   end
 
+  def new_sub_builder_nif(_builder_res) do
+    unimplemented().on_unimplemented()
+  end
+
+  def merge_builders_nif(_builder_res, _blocks) do
+    unimplemented().on_unimplemented()
+  end
+
   def new_bool_var_nif(_cp_model_builder, _name) do
     unimplemented().on_unimplemented()
   end
@@ -38,6 +46,14 @@ defmodule Exhort.NIF.Nif do
     unimplemented().on_unimplemented()
   end
 
+  def new_fixed_size_interval_var_nif(_builder, _name, _start, _size) do
+    unimplemented().on_unimplemented()
+  end
+
+  def new_optional_fixed_size_interval_var_nif(_builder, _name, _start, _size, _presence) do
+    unimplemented().on_unimplemented()
+  end
+
   def add_equal_expr1_expr2_nif(_cp_model_builder, _expr1, _expr2) do
     unimplemented().on_unimplemented()
   end
@@ -98,6 +114,30 @@ defmodule Exhort.NIF.Nif do
     unimplemented().on_unimplemented()
   end
 
+  def add_cumulative_nif(_builder, _capacity, _intervals, _demands) do
+    unimplemented().on_unimplemented()
+  end
+
+  def add_cumulative_demands_nif(_builder, _cumulative, _intervals, _demands) do
+    unimplemented().on_unimplemented()
+  end
+
+  def add_allowed_assignments_nif(_builder, _vars, _tuples) do
+    unimplemented().on_unimplemented()
+  end
+
+  def add_forbidden_assignments_nif(_builder, _vars, _tuples) do
+    unimplemented().on_unimplemented()
+  end
+
+  def add_circuit_nif(_builder, _arcs) do
+    unimplemented().on_unimplemented()
+  end
+
+  def add_multiple_circuit_nif(_builder, _arcs) do
+    unimplemented().on_unimplemented()
+  end
+
   def add_bool_or_nif(_builder, _var_list) do
     unimplemented().on_unimplemented()
   end
@@ -110,11 +150,19 @@ defmodule Exhort.NIF.Nif do
     unimplemented().on_unimplemented()
   end
 
-  def solve_nif(_cp_model_builder) do
+  def solve_nif(_cp_model_builder, _options) do
     unimplemented().on_unimplemented()
   end
 
-  def solve_with_callback_nif(_cp_model_builder, _pid) do
+  def solve_with_callback_nif(_cp_model_builder, _pid, _options) do
+    unimplemented().on_unimplemented()
+  end
+
+  def solve_lexicographic_nif(_cp_model_builder, _objectives, _options) do
+    unimplemented().on_unimplemented()
+  end
+
+  def improve_nif(_cp_model_builder, _response, _neighbourhood, _options) do
     unimplemented().on_unimplemented()
   end
 
@@ -181,6 +229,70 @@ defmodule Exhort.NIF.Nif do
     unimplemented().on_unimplemented()
   end
 
+  def profile_model_nif(_builder, _top) do
+    unimplemented().on_unimplemented()
+  end
+
+  def enumerate_to_file_nif(_builder, _path, _vars, _options) do
+    unimplemented().on_unimplemented()
+  end
+
+  def import_model_nif(_format, _source) do
+    unimplemented().on_unimplemented()
+  end
+
+  def serialize_model_nif(_builder) do
+    unimplemented().on_unimplemented()
+  end
+
+  def new_solve_cancel_nif do
+    unimplemented().on_unimplemented()
+  end
+
+  def cancel_solve_nif(_cancel) do
+    unimplemented().on_unimplemented()
+  end
+
+  def solve_serialized_nif(_model, _options, _cancel) do
+    unimplemented().on_unimplemented()
+  end
+
+  def decode_response_nif(_response) do
+    unimplemented().on_unimplemented()
+  end
+
+  def open_solution_file_nif(_path) do
+    unimplemented().on_unimplemented()
+  end
+
+  def read_solution_rows_nif(_solution_file, _first, _count) do
+    unimplemented().on_unimplemented()
+  end
+
+  def solution_pool_nif(_builder, _vars, _options) do
+    unimplemented().on_unimplemented()
+  end
+
+  def presolve_nif(_builder, _options) do
+    unimplemented().on_unimplemented()
+  end
+
+  def presolved_domain_nif(_presolved, _var) do
+    unimplemented().on_unimplemented()
+  end
+
+  def solve_presolved_nif(_presolved, _objective, _options) do
+    unimplemented().on_unimplemented()
+  end
+
+  def native_memory_nif do
+    unimplemented().on_unimplemented()
+  end
+
+  def native_resources_nif do
+    unimplemented().on_unimplemented()
+  end
+
   defp unimplemented() do
     Application.get_env(:exhort, :unimplemented, Exhort.NIF.RaiseUnimplemented)
   end
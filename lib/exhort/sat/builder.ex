@@ -42,6 +42,9 @@ defmodule Exhort.SAT.Builder do
     end
   end
 
+  # Constraints and objectives are listed newest first, so that adding one is
+  # constant time, and are put back in definition order by `build/1`.
+
   @type t :: %__MODULE__{}
   defstruct res: nil, vars: %Vars{}, constraints: [], objectives: [], decision_strategy: nil
 
@@ -74,7 +77,7 @@ defmodule Exhort.SAT.Builder do
   end
 
   def add(%Builder{constraints: constraints} = builder, %Constraint{} = constraint) do
-    %Builder{builder | constraints: constraints ++ [constraint]}
+    %Builder{builder | constraints: [constraint | constraints]}
   end
 
   @doc """
@@ -122,6 +125,26 @@ defmodule Exhort.SAT.Builder do
     }
   end
 
+  @doc """
+  Define an interval variable of a fixed size in the model.
+
+  Unlike `def_interval_var/6`, the end of the interval is not a variable of the
+  model, so the interval only needs an expression for its start.
+
+  - `name` is the variable name
+  - `start` is the start of the interval, a variable or an expression
+  - `size` is the size of the interval, an integer
+  - `opts` may specify `if: bool_var`, where `bool_var` being a previously
+    defined boolean variable
+  """
+  def def_fixed_interval_var(%Builder{vars: vars} = builder, name, start, size, opts \\ [])
+      when is_integer(size) do
+    %Builder{
+      builder
+      | vars: Vars.add(vars, %IntervalVar{name: name, start: start, size: size, opts: opts})
+    }
+  end
+
   @doc """
   Create a named constant. `value` should be a constant integer.
   """
@@ -203,9 +226,10 @@ defmodule Exhort.SAT.Builder do
 
       %Builder{
         builder
-        | constraints:
-            builder.constraints ++
-              [%Constraint{defn: {unquote(lhs), unquote(op), unquote(rhs), unquote(opts)}}]
+        | constraints: [
+            %Constraint{defn: {unquote(lhs), unquote(op), unquote(rhs), unquote(opts)}}
+            | builder.constraints
+          ]
       }
     end
   end
@@ -221,21 +245,41 @@ defmodule Exhort.SAT.Builder do
   def constrain(%Builder{} = builder, lhs, constraint, rhs, opts \\ []) do
     %Builder{
       builder
-      | constraints: builder.constraints ++ [%Constraint{defn: {lhs, constraint, rhs, opts}}]
+      | constraints: [%Constraint{defn: {lhs, constraint, rhs, opts}} | builder.constraints]
     }
   end
 
   @doc """
   Apply the constraint to the given list.
 
+  For `:cumulative`, the list holds `{interval, demand}` pairs and `opts` must
+  specify the `capacity:` shared by the intervals.
+
+  For `:allowed_assignments` and `:forbidden_assignments`, the list holds the
+  variables and `opts` must specify the `tuples:` of values the variables may,
+  or may not, take together. The tuples are lists or tuples of integers, or a
+  binary of native signed 64-bit integers, one row of values per tuple, which
+  is read natively without copying.
+
+  For `:circuit` and `:multiple_circuit`, the list holds `{tail, head,
+  literal}` arcs between nodes numbered from 0, where `literal` is true when
+  the arc is used. The arcs may also be given as a binary of native signed
+  32-bit integers, a `(tail, head, literal)` triple per arc, where the literal
+  is the model index `i` of a boolean variable or `-i - 1` for its negation.
+
   See `Exhort.SAT.Constraint` for the list of constraints.
   """
-  @spec constrain_list(Builder.t(), Constraint.constraint(), list(), opts :: Keyword.t()) ::
+  @spec constrain_list(
+          Builder.t(),
+          Constraint.constraint(),
+          list() | binary(),
+          opts :: Keyword.t()
+        ) ::
           Builder.t()
   def constrain_list(%Builder{} = builder, constraint, list, opts \\ []) do
     %Builder{
       builder
-      | constraints: builder.constraints ++ [%Constraint{defn: {constraint, list, opts}}]
+      | constraints: [%Constraint{defn: {constraint, list, opts}} | builder.constraints]
     }
   end
 
@@ -245,30 +289,49 @@ defmodule Exhort.SAT.Builder do
   @spec max_equality(Builder.t(), literal :: atom() | String.t() | IntVar.t(), list()) ::
           Builder.t()
   def max_equality(builder, literal, list) do
-    %Builder{builder | objectives: builder.objectives ++ [{:max_equality, literal, list}]}
+    %Builder{builder | objectives: [{:max_equality, literal, list} | builder.objectives]}
   end
 
   @doc """
-  Specify an objective to minimize `literal`.
+  Specify an objective to minimize `expression`.
+
+  More than one objective may be specified with `minimize/3` and `maximize/3`.
+  The objectives are then optimized lexicographically, in the order they were
+  specified: each objective is optimized while the ones before it are held at
+  their optimum.
+
+  - `opts` may specify `tolerance: integer`, by how much this objective may
+    move away from its optimum while the objectives after it are optimized.
+    Defaults to 0.
   """
-  defmacro minimize(builder, expression) do
+  defmacro minimize(builder, expression, opts \\ []) do
     expression = DSL.transform_expression(expression)
 
     quote do
       %Builder{vars: vars} = builder = unquote(builder)
-      %Builder{builder | objectives: builder.objectives ++ [{:minimize, unquote(expression)}]}
+
+      %Builder{
+        builder
+        | objectives: [{:minimize, unquote(expression), unquote(opts)} | builder.objectives]
+      }
     end
   end
 
   @doc """
   Specify an objective to maximize `expression`.
+
+  See `minimize/3` for specifying more than one objective.
   """
-  defmacro maximize(builder, expression) do
+  defmacro maximize(builder, expression, opts \\ []) do
     expression = DSL.transform_expression(expression)
 
     quote do
       %Builder{vars: vars} = builder = unquote(builder)
-      %Builder{builder | objectives: builder.objectives ++ [{:maximize, unquote(expression)}]}
+
+      %Builder{
+        builder
+        | objectives: [{:maximize, unquote(expression), unquote(opts)} | builder.objectives]
+      }
     end
   end
 
@@ -312,174 +375,288 @@ defmodule Exhort.SAT.Builder do
   def build(%Builder{} = builder) do
     builder = %Builder{builder | res: Nif.new_builder_nif()}
 
-    vars =
-      Vars.iter(builder.vars)
-      |> Enum.reduce(%Vars{}, fn
-        %BoolVar{name: name} = var, vars ->
-          %BoolVar{res: res} = new_bool_var(builder, name)
-          Vars.add(vars, %BoolVar{var | res: res})
-
-        %IntVar{name: name, domain: {upper_bound, lower_bound}} = var, vars ->
-          %IntVar{res: res} = new_int_var(builder, upper_bound, lower_bound, name)
-          Vars.add(vars, %IntVar{var | res: res})
-
-        %IntVar{name: name, domain: constant} = var, vars ->
-          %IntVar{res: res} = new_constant(builder, name, constant)
-          Vars.add(vars, %IntVar{var | res: res})
-
-        %IntervalVar{
-          name: name,
-          start: start,
-          size: size,
-          stop: stop,
-          opts: [if: presence]
-        } = var,
-        vars ->
-          start =
-            Vars.get(vars, start)
-            |> LinearExpression.resolve(vars)
-
-          size = LinearExpression.resolve(size, vars)
-
-          stop =
-            Vars.get(vars, stop)
-            |> LinearExpression.resolve(vars)
-
-          presence = BoolVar.resolve(presence, vars)
-
-          %IntervalVar{res: res} =
-            new_interval_var(builder, name, start, size, stop, if: presence)
+    vars = define_vars(builder, Vars.iter(builder.vars), %Vars{})
+    builder = %Builder{builder | vars: vars}
 
-          Vars.add(vars, %IntervalVar{
-            var
-            | res: res,
-              start: start,
-              size: size,
-              stop: stop,
-              opts: [if: presence]
-          })
+    constraints = add_constraints(builder, Enum.reverse(builder.constraints), vars)
+    builder = %Builder{builder | constraints: constraints}
 
-        %IntervalVar{name: name, start: start, size: size, stop: stop, opts: opts} = var, vars ->
-          start =
-            Vars.get(vars, start)
-            |> LinearExpression.resolve(vars)
+    objectives =
+      builder.objectives
+      |> Enum.reverse()
+      |> Enum.flat_map(fn
+        {:max_equality, name, list} ->
+          add_max_equality(builder, Vars.get(vars, name), list)
+          []
+
+        {direction, expr1, opts} ->
+          expr1 = LinearExpression.resolve(expr1, vars)
+          [{direction, expr1, Keyword.get(opts, :tolerance, 0)}]
+      end)
 
-          size = LinearExpression.resolve(size, vars)
+    # Several objectives are optimized in turn when the model is solved.
+    case objectives do
+      [{:minimize, expr1, _tolerance}] -> add_minimize(builder, expr1)
+      [{:maximize, expr1, _tolerance}] -> add_maximize(builder, expr1)
+      _ -> nil
+    end
 
-          stop =
-            Vars.get(vars, stop)
-            |> LinearExpression.resolve(vars)
+    add_decision_strategy(builder, builder.decision_strategy, vars)
 
-          %IntervalVar{res: res} = new_interval_var(builder, name, start, size, stop, opts)
+    %Model{res: builder.res, vars: vars, constraints: constraints, objectives: objectives}
+  end
 
-          Vars.add(vars, %IntervalVar{
-            var
-            | res: res,
-              start: start,
-              size: size,
-              stop: stop,
-              opts: opts
-          })
-      end)
+  @doc """
+  Build the model from `builder` and a list of `blocks`, building the blocks
+  concurrently.
 
-    builder = %Builder{builder | vars: vars}
+  Each block is a builder of its own variables and constraints, which may also
+  refer to the variables defined in `builder`. Each block is built in its own
+  process into a native sub-builder that shares the variables of `builder`, and
+  the sub-builders are then merged into the model, in order.
+
+  Objectives and the decision strategy are taken from `builder`; blocks may
+  only add constraints, including `max_equality/3`. Variable names must be
+  unique across `builder` and the blocks.
+
+  - `opts` may specify `max_concurrency: integer`, the number of blocks built
+    at once. Defaults to `System.schedulers_online/0`.
+  """
+  @spec build(Builder.t(), [Builder.t()], Keyword.t()) :: Model.t()
+  def build(%Builder{} = builder, blocks, opts \\ []) when is_list(blocks) do
+    %Model{res: res, vars: vars, constraints: constraints} = model = build(builder)
+
+    blocks =
+      blocks
+      |> Task.async_stream(&build_block(model, &1),
+        max_concurrency: Keyword.get(opts, :max_concurrency, System.schedulers_online()),
+        ordered: true,
+        timeout: :infinity
+      )
+      |> Enum.map(fn {:ok, block} -> block end)
+
+    merged =
+      Nif.merge_builders_nif(
+        res,
+        Enum.map(blocks, fn {block_res, block_vars, _constraints} ->
+          {block_res, Enum.map(block_vars, & &1.res)}
+        end)
+      )
 
-    constraints =
-      builder.constraints
-      |> Enum.map(fn
-        %Constraint{defn: {lhs, :==, rhs, opts}} = constraint ->
-          lhs = LinearExpression.resolve(lhs, vars)
-          rhs = LinearExpression.resolve(rhs, vars)
-          res = builder |> add_equal(lhs, rhs) |> modify(opts, vars)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {lhs, :!=, rhs, opts}} = constraint ->
-          lhs = LinearExpression.resolve(lhs, vars)
-          rhs = LinearExpression.resolve(rhs, vars)
-          res = builder |> add_not_equal(lhs, rhs) |> modify(opts, vars)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {lhs, :>, rhs, opts}} = constraint ->
-          lhs = LinearExpression.resolve(lhs, vars)
-          rhs = LinearExpression.resolve(rhs, vars)
-          res = builder |> add_greater_than(lhs, rhs) |> modify(opts, vars)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {lhs, :>=, rhs, opts}} = constraint ->
-          lhs = LinearExpression.resolve(lhs, vars)
-          rhs = LinearExpression.resolve(rhs, vars)
-          res = builder |> add_greater_or_equal(lhs, rhs) |> modify(opts, vars)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {lhs, :<, rhs, opts}} = constraint ->
-          lhs = LinearExpression.resolve(lhs, vars)
-          rhs = LinearExpression.resolve(rhs, vars)
-          res = builder |> add_less_than(lhs, rhs) |> modify(opts, vars)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {lhs, :<=, rhs, opts}} = constraint ->
-          lhs = LinearExpression.resolve(lhs, vars)
-          rhs = LinearExpression.resolve(rhs, vars)
-          res = builder |> add_less_or_equal(lhs, rhs) |> modify(opts, vars)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {lhs, :"abs==", rhs, opts}} = constraint when is_integer(lhs) ->
-          res = builder |> add_abs_equal(lhs, Vars.get(vars, rhs)) |> modify(opts, vars)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {lhs, :"abs==", rhs, opts}} = constraint ->
-          res =
-            builder
-            |> add_abs_equal(Vars.get(vars, lhs), Vars.get(vars, rhs))
-            |> modify(opts, vars)
-
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {:implication, lhs, rhs}} = constraint ->
-          lhs = BoolVar.resolve(lhs, vars)
-          rhs = BoolVar.resolve(rhs, vars)
-          res = add_implication(builder, lhs, rhs)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {:or, list}} = constraint ->
-          list = Enum.map(list, &BoolVar.resolve(&1, vars))
-          res = add_bool_or(builder, list)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {:and, list}} = constraint ->
-          list = Enum.map(list, &BoolVar.resolve(&1, vars))
-          res = add_bool_and(builder, list)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {:"all!=", list, opts}} = constraint ->
-          list = Enum.map(list, &LinearExpression.resolve(&1, vars))
-          res = builder |> add_all_different(list) |> modify(opts, vars)
-          %Constraint{constraint | res: res}
-
-        %Constraint{defn: {:no_overlap, list, opts}} = constraint ->
-          res = builder |> add_no_overlap(list) |> modify(opts, vars)
-          %Constraint{constraint | res: res}
+    vars =
+      blocks
+      |> Enum.zip(merged)
+      |> Enum.reduce(vars, fn {{_block_res, block_vars, _constraints}, refs}, vars ->
+        block_vars
+        |> Enum.zip(refs)
+        |> Enum.reduce(vars, fn {var, ref}, vars -> Vars.add(vars, %{var | res: ref}) end)
       end)
 
-    builder = %Builder{builder | constraints: constraints}
+    block_constraints = Enum.flat_map(blocks, fn {_block_res, _block_vars, cs} -> cs end)
 
-    builder.objectives
-    |> Enum.map(fn
-      {:max_equality, name, list} ->
-        add_max_equality(builder, Vars.get(vars, name), list)
+    %Model{model | vars: vars, constraints: constraints ++ block_constraints}
+  end
 
-      {:minimize, expr1} ->
-        expr1 = LinearExpression.resolve(expr1, vars)
-        add_minimize(builder, expr1)
+  defp build_block(%Model{res: res, vars: vars}, %Builder{decision_strategy: nil} = block) do
+    builder = %Builder{block | res: Nif.new_sub_builder_nif(res)}
 
-      {:maximize, expr1} ->
-        expr1 = LinearExpression.resolve(expr1, vars)
-        add_maximize(builder, expr1)
+    block_vars = define_vars(builder, Vars.iter(block.vars), vars)
+    builder = %Builder{builder | vars: block_vars}
+
+    constraints = add_constraints(builder, Enum.reverse(block.constraints), block_vars)
+
+    block.objectives
+    |> Enum.reverse()
+    |> Enum.each(fn
+      {:max_equality, name, list} ->
+        add_max_equality(builder, Vars.get(block_vars, name), list)
+
+      _objective ->
+        raise ArgumentError, "Objectives may only be specified on the model builder"
     end)
 
-    add_decision_strategy(builder, builder.decision_strategy, vars)
+    {builder.res, Enum.drop(Vars.iter(block_vars), length(Vars.iter(vars))), constraints}
+  end
+
+  defp build_block(_model, %Builder{}) do
+    raise ArgumentError, "A decision strategy may only be specified on the model builder"
+  end
+
+  defp define_vars(builder, list, vars) do
+    Enum.reduce(list, vars, fn
+      %BoolVar{name: name} = var, vars ->
+        %BoolVar{res: res} = new_bool_var(builder, name)
+        Vars.add(vars, %BoolVar{var | res: res})
+
+      %IntVar{name: name, domain: {upper_bound, lower_bound}} = var, vars ->
+        %IntVar{res: res} = new_int_var(builder, upper_bound, lower_bound, name)
+        Vars.add(vars, %IntVar{var | res: res})
+
+      %IntVar{name: name, domain: constant} = var, vars ->
+        %IntVar{res: res} = new_constant(builder, name, constant)
+        Vars.add(vars, %IntVar{var | res: res})
+
+      %IntervalVar{name: name, start: start, size: size, stop: nil, opts: opts} = var, vars
+      when is_integer(size) ->
+        start = LinearExpression.resolve(start, vars)
+        opts = Enum.map(opts, fn {:if, presence} -> {:if, BoolVar.resolve(presence, vars)} end)
+
+        %IntervalVar{res: res} = new_fixed_size_interval_var(builder, name, start, size, opts)
+
+        Vars.add(vars, %IntervalVar{var | res: res, start: start, opts: opts})
+
+      %IntervalVar{
+        name: name,
+        start: start,
+        size: size,
+        stop: stop,
+        opts: [if: presence]
+      } = var,
+      vars ->
+        start =
+          Vars.get(vars, start)
+          |> LinearExpression.resolve(vars)
+
+        size = LinearExpression.resolve(size, vars)
+
+        stop =
+          Vars.get(vars, stop)
+          |> LinearExpression.resolve(vars)
+
+        presence = BoolVar.resolve(presence, vars)
+
+        %IntervalVar{res: res} =
+          new_interval_var(builder, name, start, size, stop, if: presence)
+
+        Vars.add(vars, %IntervalVar{
+          var
+          | res: res,
+            start: start,
+            size: size,
+            stop: stop,
+            opts: [if: presence]
+        })
+
+      %IntervalVar{name: name, start: start, size: size, stop: stop, opts: opts} = var, vars ->
+        start =
+          Vars.get(vars, start)
+          |> LinearExpression.resolve(vars)
+
+        size = LinearExpression.resolve(size, vars)
+
+        stop =
+          Vars.get(vars, stop)
+          |> LinearExpression.resolve(vars)
 
-    %Model{res: builder.res, vars: vars, constraints: constraints}
+        %IntervalVar{res: res} = new_interval_var(builder, name, start, size, stop, opts)
+
+        Vars.add(vars, %IntervalVar{
+          var
+          | res: res,
+            start: start,
+            size: size,
+            stop: stop,
+            opts: opts
+        })
+    end)
+  end
+
+  defp add_constraints(builder, constraints, vars) do
+    Enum.map(constraints, fn
+      %Constraint{defn: {lhs, :==, rhs, opts}} = constraint ->
+        lhs = LinearExpression.resolve(lhs, vars)
+        rhs = LinearExpression.resolve(rhs, vars)
+        res = builder |> add_equal(lhs, rhs) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {lhs, :!=, rhs, opts}} = constraint ->
+        lhs = LinearExpression.resolve(lhs, vars)
+        rhs = LinearExpression.resolve(rhs, vars)
+        res = builder |> add_not_equal(lhs, rhs) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {lhs, :>, rhs, opts}} = constraint ->
+        lhs = LinearExpression.resolve(lhs, vars)
+        rhs = LinearExpression.resolve(rhs, vars)
+        res = builder |> add_greater_than(lhs, rhs) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {lhs, :>=, rhs, opts}} = constraint ->
+        lhs = LinearExpression.resolve(lhs, vars)
+        rhs = LinearExpression.resolve(rhs, vars)
+        res = builder |> add_greater_or_equal(lhs, rhs) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {lhs, :<, rhs, opts}} = constraint ->
+        lhs = LinearExpression.resolve(lhs, vars)
+        rhs = LinearExpression.resolve(rhs, vars)
+        res = builder |> add_less_than(lhs, rhs) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {lhs, :<=, rhs, opts}} = constraint ->
+        lhs = LinearExpression.resolve(lhs, vars)
+        rhs = LinearExpression.resolve(rhs, vars)
+        res = builder |> add_less_or_equal(lhs, rhs) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {lhs, :"abs==", rhs, opts}} = constraint when is_integer(lhs) ->
+        res = builder |> add_abs_equal(lhs, Vars.get(vars, rhs)) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {lhs, :"abs==", rhs, opts}} = constraint ->
+        res =
+          builder
+          |> add_abs_equal(Vars.get(vars, lhs), Vars.get(vars, rhs))
+          |> modify(opts, vars)
+
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {:implication, lhs, rhs}} = constraint ->
+        lhs = BoolVar.resolve(lhs, vars)
+        rhs = BoolVar.resolve(rhs, vars)
+        res = add_implication(builder, lhs, rhs)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {:or, list}} = constraint ->
+        list = Enum.map(list, &BoolVar.resolve(&1, vars))
+        res = add_bool_or(builder, list)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {:and, list}} = constraint ->
+        list = Enum.map(list, &BoolVar.resolve(&1, vars))
+        res = add_bool_and(builder, list)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {:"all!=", list, opts}} = constraint ->
+        list = Enum.map(list, &LinearExpression.resolve(&1, vars))
+        res = builder |> add_all_different(list) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {:no_overlap, list, opts}} = constraint ->
+        res = builder |> add_no_overlap(list) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {table, list, opts}} = constraint
+      when table in [:allowed_assignments, :forbidden_assignments] ->
+        {tuples, opts} = Keyword.pop!(opts, :tuples)
+        res = builder |> add_table(table, list, tuples) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {circuit, arcs, opts}} = constraint
+      when circuit in [:circuit, :multiple_circuit] ->
+        res = builder |> add_circuit(circuit, arcs) |> modify(opts, vars)
+        %Constraint{constraint | res: res}
+
+      %Constraint{defn: {:cumulative, list, opts}} = constraint ->
+        {capacity, opts} = Keyword.pop!(opts, :capacity)
+
+        if opts != [] do
+          raise ArgumentError, "Cumulative constraints can't be enforced by a literal"
+        end
+
+        res = add_cumulative(builder, capacity, list)
+        %Constraint{constraint | res: res}
+    end)
   end
 
   defp to_str(val) when is_atom(val), do: Atom.to_string(val)
@@ -528,6 +705,24 @@ defmodule Exhort.SAT.Builder do
     %IntervalVar{res: res, name: name, start: start, size: size, stop: stop}
   end
 
+  defp new_fixed_size_interval_var(%{res: res}, name, start, size, [{:if, presence}]) do
+    res =
+      Nif.new_optional_fixed_size_interval_var_nif(
+        res,
+        to_str(name),
+        start.res,
+        size,
+        presence.res
+      )
+
+    %IntervalVar{res: res, name: name, start: start, size: size, opts: [{:if, presence}]}
+  end
+
+  defp new_fixed_size_interval_var(%{res: res}, name, start, size, []) do
+    res = Nif.new_fixed_size_interval_var_nif(res, to_str(name), start.res, size)
+    %IntervalVar{res: res, name: name, start: start, size: size}
+  end
+
   defp add_equal(cp_model_builder, %LinearExpression{} = expr1, %LinearExpression{} = expr2) do
     Nif.add_equal_expr1_expr2_nif(cp_model_builder.res, expr1.res, expr2.res)
   end
@@ -596,6 +791,60 @@ defmodule Exhort.SAT.Builder do
     end)
   end
 
+  # Demands that are all integers are sent as a packed binary of int64 values,
+  # others as a list of expressions.
+  defp add_cumulative(%Builder{res: builder_res, vars: vars} = _builder, capacity, list) do
+    capacity =
+      if is_integer(capacity), do: capacity, else: LinearExpression.resolve(capacity, vars).res
+
+    intervals = Enum.map(list, fn {interval, _demand} -> Vars.get(vars, interval).res end)
+
+    demands =
+      if Enum.all?(list, fn {_interval, demand} -> is_integer(demand) end) do
+        for {_interval, demand} <- list, into: <<>>, do: <<demand::signed-native-64>>
+      else
+        Enum.map(list, fn {_interval, demand} -> LinearExpression.resolve(demand, vars).res end)
+      end
+
+    Nif.add_cumulative_nif(builder_res, capacity, intervals, demands)
+  end
+
+  defp add_table(%Builder{res: builder_res, vars: vars} = _builder, table, list, tuples) do
+    var_list = Enum.map(list, &Vars.get(vars, &1).res)
+    tuples = pack_tuples(tuples, length(list))
+
+    case table do
+      :allowed_assignments -> Nif.add_allowed_assignments_nif(builder_res, var_list, tuples)
+      :forbidden_assignments -> Nif.add_forbidden_assignments_nif(builder_res, var_list, tuples)
+    end
+  end
+
+  defp pack_tuples(tuples, _arity) when is_binary(tuples), do: tuples
+
+  defp pack_tuples(tuples, arity) do
+    for tuple <- tuples, into: <<>> do
+      values = if is_tuple(tuple), do: Tuple.to_list(tuple), else: tuple
+
+      if length(values) != arity do
+        raise ArgumentError, "Each tuple must have a value for each of the #{arity} variables"
+      end
+
+      for value <- values, into: <<>>, do: <<value::signed-native-64>>
+    end
+  end
+
+  defp add_circuit(%Builder{res: builder_res, vars: vars} = _builder, circuit, arcs) do
+    arcs =
+      if is_binary(arcs),
+        do: arcs,
+        else: Enum.map(arcs, fn {tail, head, literal} -> {tail, head, Vars.get(vars, literal).res} end)
+
+    case circuit do
+      :circuit -> Nif.add_circuit_nif(builder_res, arcs)
+      :multiple_circuit -> Nif.add_multiple_circuit_nif(builder_res, arcs)
+    end
+  end
+
   defp modify(constraint, opts, vars) do
     Enum.each(opts, fn
       {:if, sym} ->
@@ -15,7 +15,8 @@ defmodule Exhort.SAT.Constraint do
   The list constraints are:
 
   ```
-  :"all!=" | :no_overlap
+  :"all!=" | :no_overlap | :cumulative | :allowed_assignments | :forbidden_assignments
+  | :circuit | :multiple_circuit
   ```
 
   The expression must include a boundary: `<`, `<=`, `==`, `>=`, `>`.
@@ -72,7 +73,20 @@ defmodule Exhort.SAT.Constraint do
   alias Exhort.SAT.IntVar
   alias Exhort.SAT.LinearExpression
 
-  @type constraint :: :< | :<= | :== | :>= | :> | :"abs==" | :"all!=" | :no_overlap
+  @type constraint ::
+          :<
+          | :<=
+          | :==
+          | :>=
+          | :>
+          | :"abs=="
+          | :"all!="
+          | :no_overlap
+          | :cumulative
+          | :allowed_assignments
+          | :forbidden_assignments
+          | :circuit
+          | :multiple_circuit
 
   @type t :: %__MODULE__{}
   defstruct [:res, :defn]
@@ -142,6 +156,69 @@ defmodule Exhort.SAT.Constraint do
     %Constraint{defn: {:no_overlap, list, opts}}
   end
 
+  @doc """
+  Create a constraint that ensures the demands of the intervals running at any
+  time are within a capacity.
+
+  - `list` is a list of `{interval, demand}`, where `demand` is an integer or
+    an expression
+  - `opts` must specify `capacity:`, an integer or an expression
+
+  CP-SAT doesn't support enforcement literals on cumulative constraints, so
+  `if:` and `unless:` are rejected.
+  """
+  @spec cumulative(list(), Keyword.t()) :: Exhort.SAT.Constraint.t()
+  def cumulative(list, opts) do
+    Keyword.fetch!(opts, :capacity)
+    %Constraint{defn: {:cumulative, list, opts}}
+  end
+
+  @doc """
+  Create a constraint that ensures the variables in the list take the values
+  of one of the `tuples` together.
+
+  The tuples are lists or tuples of integers, or a binary of native signed
+  64-bit integers, one row of values per tuple.
+  """
+  @spec allowed_assignments(list(), list() | binary(), Keyword.t()) :: Exhort.SAT.Constraint.t()
+  def allowed_assignments(list, tuples, opts \\ []) do
+    %Constraint{defn: {:allowed_assignments, list, [{:tuples, tuples} | opts]}}
+  end
+
+  @doc """
+  Create a constraint that ensures the variables in the list don't take the
+  values of any of the `tuples` together. See `allowed_assignments/3`.
+  """
+  @spec forbidden_assignments(list(), list() | binary(), Keyword.t()) ::
+          Exhort.SAT.Constraint.t()
+  def forbidden_assignments(list, tuples, opts \\ []) do
+    %Constraint{defn: {:forbidden_assignments, list, [{:tuples, tuples} | opts]}}
+  end
+
+  @doc """
+  Create a constraint that ensures the arcs whose literal is true form a
+  single circuit through every node, as in the travelling salesman problem.
+
+  Each arc is a `{tail, head, literal}` tuple, between nodes numbered from 0.
+  A node left out of the circuit has a self-loop arc `{node, node, literal}`
+  whose literal is true. See `Exhort.SAT.Builder.constrain_list/4` for the
+  packed binary form of the arcs.
+  """
+  @spec circuit(list() | binary(), Keyword.t()) :: Exhort.SAT.Constraint.t()
+  def circuit(arcs, opts \\ []) do
+    %Constraint{defn: {:circuit, arcs, opts}}
+  end
+
+  @doc """
+  Create a constraint that ensures the arcs whose literal is true form
+  circuits through node 0, the depot, that together visit every other node
+  once, as in vehicle routing. See `circuit/2`.
+  """
+  @spec multiple_circuit(list() | binary(), Keyword.t()) :: Exhort.SAT.Constraint.t()
+  def multiple_circuit(arcs, opts \\ []) do
+    %Constraint{defn: {:multiple_circuit, arcs, opts}}
+  end
+
   @doc """
   Create a constraint that ensures each item in the list is different in the
   solution.
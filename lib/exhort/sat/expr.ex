@@ -117,6 +117,42 @@ defmodule Exhort.SAT.Expr do
   @spec no_overlap(list(), Keyword.t()) :: Constraint.t()
   defdelegate no_overlap(list, opts \\ []), to: Constraint
 
+  @doc """
+  Create a constraint on a list of `{interval, demand}` ensuring that the
+  demands of the intervals running at any time are within the `capacity:`
+  option.
+  """
+  @spec cumulative(list(), Keyword.t()) :: Constraint.t()
+  defdelegate cumulative(list, opts), to: Constraint
+
+  @doc """
+  Create a constraint on the list ensuring that the variables take the values
+  of one of the tuples together.
+  """
+  @spec allowed_assignments(list(), list() | binary(), Keyword.t()) :: Constraint.t()
+  defdelegate allowed_assignments(list, tuples, opts \\ []), to: Constraint
+
+  @doc """
+  Create a constraint on the list ensuring that the variables don't take the
+  values of any of the tuples together.
+  """
+  @spec forbidden_assignments(list(), list() | binary(), Keyword.t()) :: Constraint.t()
+  defdelegate forbidden_assignments(list, tuples, opts \\ []), to: Constraint
+
+  @doc """
+  Create a constraint ensuring that the arcs whose literal is true form a
+  single circuit through every node.
+  """
+  @spec circuit(list() | binary(), Keyword.t()) :: Constraint.t()
+  defdelegate circuit(arcs, opts \\ []), to: Constraint
+
+  @doc """
+  Create a constraint ensuring that the arcs whose literal is true form
+  circuits through node 0 that together visit every other node once.
+  """
+  @spec multiple_circuit(list() | binary(), Keyword.t()) :: Constraint.t()
+  defdelegate multiple_circuit(arcs, opts \\ []), to: Constraint
+
   @doc """
   Create a constraint on the list ensuring that each variable in the list has a
   different value.
@@ -1,27 +1,232 @@
 defmodule Exhort.SAT.Model do
   @moduledoc """
   The model built from the `Builder`.
+
+  ## Solve options
+
+  `solve/2` and `solve/3` accept these options:
+
+  - `log: pid` - Stream the CP-SAT search log to `pid`. The log is sent as
+    `{:exhort_log, lines}` messages, where `lines` is a list of binaries, one
+    per log line, in the order they were written. Without this option the
+    solver does no logging at all.
+  - `log_max_lines: integer` - The most lines sent in a single message.
+    Defaults to 64.
+  - `log_max_bytes: integer` - The most bytes buffered before a message is
+    sent. Longer lines are truncated to this size. Defaults to 16384.
+  - `log_flush_interval: integer` - The longest time, in milliseconds, a line
+    is buffered before it is sent. Defaults to 250.
+  - `progress: pid` - Send the search progress to `pid` as
+    `{:exhort_progress, %{"objective" => objective, "best_bound" => bound,
+    "walltime" => seconds}}` messages. `objective` and `bound` are `nil` until
+    the solver has found a solution or a bound.
+  - `progress_interval: integer` - The time, in milliseconds, between progress
+    messages. A message is only sent when the objective or the bound has
+    changed, and the last change is always sent when the solve ends. Defaults
+    to 500.
+  - `relative_gap_limit: float` - Stop once `|objective - best_bound|` is
+    within this fraction of `|objective|`, e.g. `0.01` for a 1% gap.
+  - `absolute_gap_limit: float` - Stop once `|objective - best_bound|` is
+    within this amount.
+  - `no_improvement_timeout: number` - Stop when no improving solution has
+    been found for this many seconds.
+  - `max_memory_in_mb: integer` - The memory budget of the solve. The solve is
+    charged with the size of the model plus the resident memory the process
+    gained since the solve started, sampled every 100 milliseconds, and stops
+    once it is over budget. The budget is not passed to CP-SAT, whose own
+    limit applies to the whole process.
+  - `time_limit: number` - Stop the search after this many seconds.
+  - `deterministic: boolean` - Search with interleaved workers, so that solving
+    the same model with the same `seed` and `num_workers` follows the same
+    search on any machine. The response's `workers` then lists the tasks, wall
+    time and deterministic time of each worker. Uses 8 workers unless
+    `num_workers` is given.
+  - `seed: integer` - The solver's random seed.
+  - `num_workers: integer` - The number of search workers.
+  - `deterministic_time_limit: number` - Stop the search after this much
+    deterministic time, which, unlike `time_limit`, does not depend on the
+    load of the machine.
+
+  The termination options are evaluated by the native solver. When one of them
+  ends the search, the response's `stop_reason` is `:gap_limit`,
+  `:no_improvement` or `:memory_limit`. See `Exhort.NativeMemory` for the
+  memory currently held natively.
   """
 
   @type t :: %__MODULE__{}
-  defstruct [:res, :vars, :constraints]
+  defstruct [:res, :vars, :constraints, objectives: [], presolved: nil]
 
   alias __MODULE__
   alias Exhort.NIF.Nif
+  alias Exhort.SAT.BoolVar
+  alias Exhort.SAT.IntVar
+  alias Exhort.SAT.LinearExpression
+  alias Exhort.SAT.ModelProfile
+  alias Exhort.SAT.SolutionFile
   alias Exhort.SAT.SolverResponse
   alias Exhort.SAT.SolutonListener
+  alias Exhort.SAT.Vars
 
   require Logger
 
+  @solve_options [
+    :log,
+    :log_max_lines,
+    :log_max_bytes,
+    :log_flush_interval,
+    :progress,
+    :progress_interval,
+    :relative_gap_limit,
+    :absolute_gap_limit,
+    :no_improvement_timeout,
+    :max_memory_in_mb,
+    :time_limit,
+    :deterministic,
+    :seed,
+    :num_workers,
+    :deterministic_time_limit
+  ]
+
+  @doc """
+  Read a model from an instance file, `format` being `:opb` or `:mps`.
+
+  The file is mapped into memory and parsed natively, straight into the
+  model's builder, so large instances don't go through the `Builder`:
+
+  - `:opb` - The pseudo-Boolean format of the PB competitions. Every variable
+    is a `BoolVar`. Only linear constraints and objectives are supported.
+  - `:mps` - The free MPS format. Every column is an `IntVar`, so each must be
+    between integer markers or have integer bounds, and every value must be
+    integral. Infinite bounds are limited to +/- 10,000,000.
+
+  The variables may be referenced by their names in the file, e.g. with
+  `SolverResponse.int_val/2`. Returns `{:error, {:parse, line, message}}` for
+  an invalid instance.
+  """
+  @spec from_file(Path.t(), :opb | :mps) :: {:ok, Model.t()} | {:error, any()}
+  def from_file(path, format) when format in [:opb, :mps] do
+    import_model(format, {:path, to_string(path)})
+  end
+
+  @doc """
+  Read a model from the contents of an instance, as with `from_file/2`.
+  """
+  @spec from_binary(binary(), :opb | :mps) :: {:ok, Model.t()} | {:error, any()}
+  def from_binary(data, format) when is_binary(data) and format in [:opb, :mps] do
+    import_model(format, data)
+  end
+
+  defp import_model(format, source) do
+    with {:ok, res, var_res} <- Nif.import_model_nif(format, source) do
+      vars =
+        Enum.reduce(var_res, %Vars{}, fn
+          {name, res}, vars when format == :opb -> Vars.add(vars, %BoolVar{name: name, res: res})
+          {name, res}, vars -> Vars.add(vars, %IntVar{name: name, res: res})
+        end)
+
+      {:ok, %Model{res: res, vars: vars, constraints: []}}
+    end
+  end
+
   @doc """
   Solve the model, returning the solution.
 
   This may only be called after the `build` function has been called.
+
+  When the model has been presolved with `presolve/2`, the solve starts from the
+  presolved model and the `objective: {:minimize | :maximize, expression}`
+  option may replace the model's objective, e.g. with
+  `LinearExpression.terms/1` for new weights.
+
+  When the model has more than one objective, the objectives are optimized
+  lexicographically in a single native call and the response's `objectives`
+  holds the value reached for each of them. When a later objective can't be
+  solved, the solution of the last solved objective is returned as
+  `:feasible`. Only this function supports several objectives; the other
+  solves raise an `ArgumentError` for such a model.
+
+  See the module documentation for the supported options.
   """
-  @spec solve(Model.t()) :: SolverResponse.t()
-  def solve(%Model{res: res} = model) when not is_nil(res) do
+  @spec solve(Model.t(), Keyword.t()) :: SolverResponse.t()
+  @spec solve(Model.t(), (SolverResponse.t(), any() -> any())) :: {SolverResponse.t(), any()}
+  def solve(model, opts \\ [])
+
+  def solve(%Model{res: res, presolved: presolved, vars: vars} = model, opts)
+      when not is_nil(res) and not is_nil(presolved) and is_list(opts) do
+    Logger.info("module=#{__MODULE__} event#solve/1 message=Triggered Presolved Model Solve")
+
+    {objective, opts} = Keyword.pop(opts, :objective)
+
+    SolverResponse.build(
+      Nif.solve_presolved_nif(presolved, resolve_objective(objective, vars), solve_options(opts)),
+      model
+    )
+  end
+
+  def solve(%Model{res: res, objectives: [_, _ | _] = objectives} = model, opts)
+      when not is_nil(res) and is_list(opts) do
+    Logger.info("module=#{__MODULE__} event#solve/1 message=Triggered Lexicographic Model Solve")
+
+    objectives =
+      Enum.map(objectives, fn {direction, expr, tolerance} -> {direction, expr.res, tolerance} end)
+
+    SolverResponse.build(
+      Nif.solve_lexicographic_nif(model.res, objectives, solve_options(opts)),
+      model
+    )
+  end
+
+  def solve(%Model{res: res} = model, opts) when not is_nil(res) and is_list(opts) do
     Logger.info("module=#{__MODULE__} event#solve/1 message=Triggered Model Solve")
-    SolverResponse.build(Nif.solve_nif(model.res), model)
+    SolverResponse.build(Nif.solve_nif(model.res, solve_options(opts)), model)
+  end
+
+  def solve(%Model{res: res} = model, callback) when not is_nil(res) and is_function(callback) do
+    solve(model, callback, [])
+  end
+
+  @doc """
+  Serialize the model and the solve options into a binary, to be solved on
+  another node with `solve_serialized/1`, e.g. through `Exhort.SAT.SolvePool`.
+
+  The binary holds the built model, without its Elixir variables, so a model
+  with several objectives or a presolved model can't be serialized and raises an
+  `ArgumentError`. The `log` and `progress` options are not supported, as their
+  processes are local.
+  """
+  @spec serialize(Model.t(), Keyword.t()) :: binary()
+  def serialize(%Model{res: res, presolved: presolved} = model, opts \\ []) when not is_nil(res) do
+    single_objective!(model, "serialize/2")
+
+    if presolved do
+      raise ArgumentError, "serialize/2 does not support presolved models"
+    end
+
+    options =
+      opts
+      |> Keyword.validate!(@solve_options -- [:log, :progress])
+      |> Map.new()
+
+    :erlang.term_to_binary({:exhort_model, 1, Nif.serialize_model_nif(res), options})
+  end
+
+  @doc """
+  Solve a model serialized with `serialize/1`, returning the response as a
+  binary to be decoded with `SolverResponse.deserialize/2` on the node the
+  model was built on.
+  """
+  @spec solve_serialized(binary()) :: binary()
+  def solve_serialized(binary), do: solve_serialized(binary, Nif.new_solve_cancel_nif())
+
+  # Solve with a handle from `Nif.new_solve_cancel_nif/0`, with which another
+  # process may stop the solve through `Nif.cancel_solve_nif/1`.
+  @doc false
+  def solve_serialized(binary, cancel) do
+    Logger.info("module=#{__MODULE__} event#solve_serialized/2 message=Triggered Serialized Model Solve")
+
+    {:exhort_model, 1, model, options} = :erlang.binary_to_term(binary, [:safe])
+    {response, stats} = Nif.solve_serialized_nif(model, options, cancel)
+    :erlang.term_to_binary({:exhort_response, 1, response, stats})
   end
 
   @doc """
@@ -30,14 +235,22 @@ defmodule Exhort.SAT.Model do
   The given function will be called on each improving feasible solution found
   during the search. For a non-optimization problem, if the option to find all
   solution was set, then this will be called on each new solution.
+
+  See the module documentation for the supported options.
   """
-  @spec solve(Model.t(), (SolverResponse.t(), any() -> any())) :: {SolverResponse.t(), any()}
-  def solve(%Model{res: res} = model, callback) when not is_nil(res) do
+  @spec solve(Model.t(), (SolverResponse.t(), any() -> any()), Keyword.t()) ::
+          {SolverResponse.t(), any()}
+  def solve(%Model{res: res} = model, callback, opts) when not is_nil(res) do
+    single_objective!(model, "solve/3")
     Logger.info("module=#{__MODULE__} event#solve/2 message=Triggered Model Solve")
 
     {:ok, pid} = SolutonListener.start_link(model, callback)
 
-    response = SolverResponse.build(Nif.solve_with_callback_nif(model.res, pid), model)
+    response =
+      SolverResponse.build(
+        Nif.solve_with_callback_nif(model.res, pid, solve_options(opts)),
+        model
+      )
 
     acc = SolutonListener.acc(pid)
 
@@ -45,4 +258,227 @@ defmodule Exhort.SAT.Model do
 
     {response, acc}
   end
+
+  @doc """
+  Enumerate every solution of the model into the file at `path`.
+
+  Each solution is written as a row of the values of `vars`, so that millions
+  of solutions may be enumerated without sending them to the BEAM. The
+  objective is ignored. Solutions are written as found, so when `vars` does not
+  cover every variable, a row may repeat.
+
+  In addition to the solve options, these options are supported:
+
+  - `max_solutions: integer` - Stop after this many solutions.
+  - `format: :int64 | :bitset` - The row format. Defaults to `:bitset` when
+    every variable in `vars` is boolean and to `:int64` otherwise.
+
+  Returns the response, with the number of `solutions` written, and the opened
+  `Exhort.SAT.SolutionFile`.
+  """
+  @spec enumerate_to_file(Model.t(), Path.t(), list(), Keyword.t()) ::
+          {:ok, SolverResponse.t(), SolutionFile.t()} | {:error, atom()}
+  def enumerate_to_file(%Model{res: res, vars: model_vars} = model, path, vars, opts \\ [])
+      when not is_nil(res) do
+    single_objective!(model, "enumerate_to_file/4")
+    Logger.info("module=#{__MODULE__} event#enumerate_to_file/4 message=Triggered Model Enumeration")
+
+    {file_opts, opts} = Keyword.split(opts, [:max_solutions, :format])
+    options = opts |> solve_options() |> Map.merge(Map.new(file_opts))
+    var_res = Enum.map(vars, &Vars.get(model_vars, &1).res)
+
+    with {:ok, response} <- Nif.enumerate_to_file_nif(res, to_string(path), var_res, options),
+         {:ok, file} <- SolutionFile.open(path, vars) do
+      {:ok, SolverResponse.build(response, model), file}
+    end
+  end
+
+  @doc """
+  Find the `k` best solutions that differ from each other.
+
+  The improving solutions of a single solve are kept natively, as rows of the
+  values of `vars`, and picked best first, skipping any that differ from a
+  picked solution in fewer than `min_distance` of `vars`. When fewer than `k`
+  remain, the model is solved again, each time constrained to differ from every
+  picked solution, until `k` are found or no other solution exists.
+
+  In addition to the solve options, these options are supported:
+
+  - `k: integer` - The number of solutions. Defaults to 5.
+  - `min_distance: integer` - The least number of `vars` in which any two
+    solutions differ. Defaults to 1.
+  - `vars: list` - The variables compared between solutions. Defaults to every
+    boolean and integer variable of the model.
+  - `resolve: boolean` - Whether to solve again for more solutions. Defaults to
+    `true`.
+
+  Returns the response of the first solve and the solutions, best first, as
+  maps of `objective` and `values`, a map of the variable names to their
+  values.
+  """
+  @spec solution_pool(Model.t(), Keyword.t()) ::
+          {SolverResponse.t(), [%{objective: float(), values: map()}]}
+  def solution_pool(%Model{res: res, vars: model_vars} = model, opts \\ [])
+      when not is_nil(res) do
+    single_objective!(model, "solution_pool/2")
+    Logger.info("module=#{__MODULE__} event#solution_pool/2 message=Triggered Model Solution Pool")
+
+    {vars, opts} = Keyword.pop_lazy(opts, :vars, fn -> pool_vars(model_vars) end)
+    {pool_opts, opts} = Keyword.split(opts, [:k, :min_distance, :resolve])
+    options = opts |> solve_options() |> Map.merge(Map.new(pool_opts))
+    var_res = Enum.map(vars, &Vars.get(model_vars, &1).res)
+
+    response = Nif.solution_pool_nif(res, var_res, options)
+
+    pool =
+      Enum.map(response["pool"], fn %{"objective" => objective, "values" => values} ->
+        %{objective: objective, values: vars |> Enum.zip(values) |> Map.new()}
+      end)
+
+    {SolverResponse.build(response, model), pool}
+  end
+
+  defp pool_vars(vars) do
+    vars
+    |> Vars.iter()
+    |> Enum.filter(&(is_struct(&1, BoolVar) or is_struct(&1, IntVar)))
+    |> Enum.map(& &1.name)
+  end
+
+  @doc """
+  Presolve the model once, for solving it many times with `solve/2`.
+
+  The model is presolved without its objective, keeping every feasible
+  solution, so that later solves may use any objective. The tightened variable
+  domains are kept natively and the returned model solves from them; see
+  `presolved_domain/2`. Later solves still run CP-SAT's presolve for its other
+  reductions, which starts from the tightened domains. The responses refer to
+  the same variables as the model.
+
+  Raises when the presolve derived no domains, e.g. when `time_limit` stopped
+  it.
+
+  Accepts the `log` options and `time_limit`.
+  """
+  @spec presolve(Model.t(), Keyword.t()) :: Model.t()
+  def presolve(%Model{res: res} = model, opts \\ []) when not is_nil(res) do
+    single_objective!(model, "presolve/2")
+    Logger.info("module=#{__MODULE__} event#presolve/2 message=Triggered Model Presolve")
+
+    case Nif.presolve_nif(res, solve_options(opts)) do
+      {:ok, presolved} -> %Model{model | presolved: presolved}
+      {:error, reason} -> raise "Presolve failed: #{inspect(reason)}"
+    end
+  end
+
+  @doc """
+  The domain of a variable in a presolved model, as a list of `{min, max}`
+  intervals.
+  """
+  @spec presolved_domain(Model.t(), var :: String.t() | atom() | IntVar.t() | BoolVar.t()) ::
+          [{integer(), integer()}]
+  def presolved_domain(%Model{presolved: presolved, vars: vars}, var) when not is_nil(presolved) do
+    Nif.presolved_domain_nif(presolved, Vars.get(vars, var).res)
+  end
+
+  @doc """
+  Profile how the model is formulated, for finding what makes it slow to solve.
+
+  - `opts` may specify `top: integer`, the number of largest constraints to
+    report. Defaults to 10.
+
+  See `Exhort.SAT.ModelProfile` for the report.
+  """
+  @spec profile(Model.t(), Keyword.t()) :: ModelProfile.t()
+  def profile(%Model{res: res}, opts \\ []) when not is_nil(res) do
+    opts = Keyword.validate!(opts, top: 10)
+
+    res
+    |> Nif.profile_model_nif(opts[:top])
+    |> ModelProfile.build()
+  end
+
+  @doc """
+  Improve the feasible solution in `response` with large neighbourhood search.
+
+  Each iteration fixes the variables outside a neighbourhood to their values in
+  the best solution found so far and re-solves the rest for a short time,
+  keeping the result when it improves the objective. The whole search runs
+  natively in a single call, without rebuilding the model.
+
+  `neighbourhood` is one of:
+
+  - `{:random, fraction}` - A random `fraction` of the model variables, e.g.
+    `{:random, 0.2}`.
+  - `{:groups, groups}` - One of the given lists of variables, e.g. all the
+    variables of one day or of one resource.
+
+  In addition to the solve options, these options are supported:
+
+  - `iterations: integer` - The number of neighbourhoods to search. Defaults to
+    100.
+  - `iteration_time_limit: number` - The time limit, in seconds, of each
+    search. Defaults to 1.
+  - `seed: integer` - The seed for choosing neighbourhoods.
+
+  When the `progress: pid` option is given, each improvement is sent to `pid`
+  as `{:exhort_improve, %{"iteration" => i, "objective" => objective,
+  "walltime" => seconds}}`, where `walltime` is the time since `improve/4`
+  started.
+
+  The returned response is `:feasible` unless `response` was already optimal.
+  """
+  @spec improve(
+          Model.t(),
+          SolverResponse.t(),
+          {:random, float()} | {:groups, [list()]},
+          Keyword.t()
+        ) :: SolverResponse.t()
+  def improve(
+        %Model{res: res, vars: vars} = model,
+        %SolverResponse{res: response_res},
+        neighbourhood,
+        opts \\ []
+      )
+      when not is_nil(res) do
+    single_objective!(model, "improve/4")
+    Logger.info("module=#{__MODULE__} event#improve/4 message=Triggered Model Improve")
+
+    {improve_opts, opts} = Keyword.split(opts, [:iterations, :iteration_time_limit, :seed])
+
+    options =
+      opts
+      |> solve_options()
+      |> Map.merge(Map.new(improve_opts))
+
+    res
+    |> Nif.improve_nif(response_res, resolve_neighbourhood(neighbourhood, vars), options)
+    |> SolverResponse.build(model)
+  end
+
+  # The model's proto only holds a single objective; several are only solved by
+  # `solve/2`.
+  defp single_objective!(%Model{objectives: [_, _ | _]}, function) do
+    raise ArgumentError, "#{function} does not support models with several objectives"
+  end
+
+  defp single_objective!(%Model{}, _function), do: :ok
+
+  defp resolve_neighbourhood({:random, fraction}, _vars), do: {:random, fraction / 1}
+
+  defp resolve_neighbourhood({:groups, groups}, vars) do
+    {:groups, Enum.map(groups, fn group -> Enum.map(group, &Vars.get(vars, &1).res) end)}
+  end
+
+  defp resolve_objective(nil, _vars), do: nil
+
+  defp resolve_objective({direction, expr}, vars) when direction in [:minimize, :maximize] do
+    {direction, LinearExpression.resolve(expr, vars).res}
+  end
+
+  defp solve_options(opts) do
+    opts
+    |> Keyword.validate!(@solve_options)
+    |> Map.new()
+  end
 end
@@ -0,0 +1,66 @@
+defmodule Exhort.SAT.ModelProfile do
+  @moduledoc """
+  A report of how a model is formulated, from `Exhort.SAT.Model.profile/2`.
+
+  - `variables` - The number of variables.
+  - `domains` - The number of variables by the width of their domain:
+    `:fixed`, `:boolean`, `:small` (up to 100 values), `:medium` (up to
+    1,000,000), `:large` and `:unbounded` (wider than 2^32 or touching the
+    64-bit limits).
+  - `domains_with_holes` - The number of variables whose domain is not a single
+    interval.
+  - `constraints` - For each constraint type, e.g. `:linear`, a map of the
+    `count` of constraints, their total and largest number of `terms` and how
+    many are `enforced` by literals, as with `only_enforce_if`.
+  - `enforcement` - A histogram of the number of enforcement literals per
+    constraint.
+  - `objective_terms` - The number of terms in the objective.
+  - `decision_strategies` - The number of decision strategies.
+  - `memory` - The estimated native memory of the model, in bytes.
+  - `serialized_size` - The size of the serialized model, in bytes.
+  - `largest_constraints` - The constraints with the most terms, largest first,
+    as maps of their `index` in the model, `type`, `terms` and `enforcement`
+    literal count.
+  """
+
+  @type t :: %__MODULE__{}
+  defstruct [
+    :variables,
+    :domains,
+    :domains_with_holes,
+    :constraints,
+    :enforcement,
+    :objective_terms,
+    :decision_strategies,
+    :memory,
+    :serialized_size,
+    :largest_constraints
+  ]
+
+  alias __MODULE__
+
+  @spec build(map()) :: ModelProfile.t()
+  def build(profile) do
+    %ModelProfile{
+      variables: profile["variables"],
+      domains: atomize(profile["domains"]),
+      domains_with_holes: profile["domains_with_holes"],
+      constraints:
+        Map.new(profile["constraints"], fn {type, c} -> {atomize_key(type), atomize(c)} end),
+      enforcement: profile["enforcement"],
+      objective_terms: profile["objective_terms"],
+      decision_strategies: profile["decision_strategies"],
+      memory: profile["memory"],
+      serialized_size: profile["serialized_size"],
+      largest_constraints:
+        Enum.map(profile["largest_constraints"], fn c ->
+          c |> atomize() |> Map.update!(:type, &atomize_key/1)
+        end)
+    }
+  end
+
+  defp atomize(map), do: Map.new(map, fn {key, value} -> {atomize_key(key), value} end)
+
+  # The keys are from the fixed set of names used by the native profiler.
+  defp atomize_key(key), do: String.to_atom(key)
+end
@@ -0,0 +1,106 @@
+defmodule Exhort.SAT.SolutionFile do
+  @moduledoc """
+  Solutions enumerated to a file with `Exhort.SAT.Model.enumerate_to_file/4`.
+
+  The file holds one fixed-width row per solution, with the values of the
+  projected variables in the order they were given. When every projected
+  variable is boolean, each row is a bitset, otherwise it is a list of 64-bit
+  integers. Rows are written in the byte order of the host.
+
+  The file is read through a memory map: reading a range of rows returns a
+  binary over the mapped pages, without copying the file into the BEAM.
+  Values are returned as integers, 0 or 1 for bitset rows.
+  """
+
+  @type t :: %__MODULE__{}
+  defstruct [:res, :path, :vars, :indexes, :format, :rows, :row_bytes]
+
+  alias __MODULE__
+  alias Exhort.NIF.Nif
+
+  @doc """
+  Open and map the solution file at `path`.
+
+  `vars` optionally names the projected variables, as given when the file was
+  written.
+  """
+  @spec open(Path.t(), list() | nil) :: {:ok, SolutionFile.t()} | {:error, atom()}
+  def open(path, vars \\ nil) do
+    case Nif.open_solution_file_nif(to_string(path)) do
+      {:ok, res, info} ->
+        {:ok,
+         %SolutionFile{
+           res: res,
+           path: path,
+           vars: vars,
+           indexes: info["vars"],
+           format: info["format"],
+           rows: info["rows"],
+           row_bytes: info["row_bytes"]
+         }}
+
+      {:error, reason} ->
+        {:error, reason}
+    end
+  end
+
+  @doc """
+  The values of the projected variables in solution `i`, counting from 0.
+  """
+  @spec get(SolutionFile.t(), non_neg_integer()) :: [integer()]
+  def get(%SolutionFile{rows: rows} = file, i) when i >= 0 and i < rows do
+    [row] = read(file, i, 1)
+    row
+  end
+
+  @doc """
+  Read `count` solutions starting with solution `first`.
+  """
+  @spec read(SolutionFile.t(), non_neg_integer(), non_neg_integer()) :: [[integer()]]
+  def read(%SolutionFile{res: res, rows: rows, row_bytes: 0}, first, count) do
+    # An empty projection has empty rows, which the binary can't count.
+    Nif.read_solution_rows_nif(res, first, count)
+    List.duplicate([], min(count, rows - first))
+  end
+
+  def read(%SolutionFile{res: res} = file, first, count) do
+    res
+    |> Nif.read_solution_rows_nif(first, count)
+    |> decode(file)
+  end
+
+  @doc """
+  Stream every solution, reading `page_rows` rows from the file at a time.
+  """
+  @spec stream(SolutionFile.t(), pos_integer()) :: Enumerable.t()
+  def stream(%SolutionFile{rows: rows} = file, page_rows \\ 4096) do
+    0
+    |> Stream.iterate(&(&1 + page_rows))
+    |> Stream.take_while(&(&1 < rows))
+    |> Stream.flat_map(&read(file, &1, page_rows))
+  end
+
+  @doc """
+  The solution `i` as a map of the variable names given to `open/2`.
+  """
+  @spec to_map(SolutionFile.t(), non_neg_integer()) :: map()
+  def to_map(%SolutionFile{vars: vars} = file, i) when is_list(vars) do
+    vars
+    |> Enum.zip(get(file, i))
+    |> Map.new()
+  end
+
+  defp decode(binary, %SolutionFile{format: :int64, indexes: indexes}) do
+    for(<<value::signed-native-64 <- binary>>, do: value)
+    |> Enum.chunk_every(length(indexes))
+  end
+
+  defp decode(binary, %SolutionFile{format: :bitset, indexes: indexes, row_bytes: row_bytes}) do
+    num_vars = length(indexes)
+
+    for <<row::binary-size(row_bytes) <- binary>> do
+      for(<<byte <- row>>, bit <- 0..7, do: Bitwise.band(Bitwise.bsr(byte, bit), 1))
+      |> Enum.take(num_vars)
+    end
+  end
+end
@@ -0,0 +1,158 @@
+defmodule Exhort.SAT.SolvePool do
+  @moduledoc """
+  Solve models built on other nodes.
+
+  Builder and response resources can't leave the node they were made on, so a
+  model is sent to the pool serialized with `Model.serialize/2` and the
+  response comes back serialized, to be decoded with
+  `SolverResponse.deserialize/2` on the node the model was built on. The
+  variables of the model may then be used with the response as usual.
+
+  Start the pool on the solving nodes, e.g. in a supervision tree:
+
+      children = [{Exhort.SAT.SolvePool, max_concurrency: 2}]
+
+  And solve from any node of the cluster:
+
+      response = SolvePool.solve({SolvePool, :"solver@host"}, model, time_limit: 10)
+
+  Solves beyond `max_concurrency`, which defaults to 1 as each solve uses
+  every core by default, wait for a running solve to finish. A solve whose
+  caller exits or stops waiting is dropped from the queue, or cancelled when it
+  is running.
+  """
+
+  use GenServer
+
+  alias __MODULE__
+  alias Exhort.NIF.Nif
+  alias Exhort.SAT.Model
+  alias Exhort.SAT.SolverResponse
+
+  require Logger
+
+  # Each solve is keyed by the monitor of its caller in `solves`, and
+  # `running` maps the monitor of each solving process to its caller's.
+  defstruct max_concurrency: 1, solves: %{}, running: %{}, queue: :queue.new()
+
+  @doc """
+  Start the pool, registered as `Exhort.SAT.SolvePool` unless `name` is given.
+  """
+  @spec start_link(Keyword.t()) :: GenServer.on_start()
+  def start_link(opts \\ []) do
+    {name, opts} = Keyword.pop(opts, :name, __MODULE__)
+    GenServer.start_link(__MODULE__, opts, name: name)
+  end
+
+  @doc """
+  Solve `model` on the pool `server`, which may be on another node.
+
+  Accepts the options of `Model.serialize/2` and `timeout`, the longest time
+  to wait for the response, which defaults to `:infinity`.
+  """
+  @spec solve(GenServer.server(), Model.t(), Keyword.t()) :: SolverResponse.t()
+  def solve(server, %Model{} = model, opts \\ []) do
+    {timeout, opts} = Keyword.pop(opts, :timeout, :infinity)
+
+    case GenServer.call(server, {:solve, Model.serialize(model, opts), timeout}, timeout) do
+      {:ok, response} -> SolverResponse.deserialize(response, model)
+      {:error, reason} -> raise "Remote solve failed: #{inspect(reason)}"
+    end
+  end
+
+  @impl true
+  def init(opts) do
+    {:ok, %SolvePool{max_concurrency: Keyword.get(opts, :max_concurrency, 1)}}
+  end
+
+  @impl true
+  def handle_call({:solve, model, timeout}, {caller, _tag} = from, %SolvePool{} = pool) do
+    ref = Process.monitor(caller)
+    timer = if timeout != :infinity, do: Process.send_after(self(), {:solve_timeout, ref}, timeout)
+    solve = %{from: from, timer: timer, cancel: nil}
+    pool = %SolvePool{pool | solves: Map.put(pool.solves, ref, solve)}
+
+    if map_size(pool.running) < pool.max_concurrency do
+      {:noreply, start(pool, ref, model)}
+    else
+      {:noreply, %SolvePool{pool | queue: :queue.in({ref, model}, pool.queue)}}
+    end
+  end
+
+  @impl true
+  def handle_info({:DOWN, ref, :process, _pid, reason}, %SolvePool{running: running} = pool)
+      when is_map_key(running, ref) do
+    {caller_ref, running} = Map.pop(running, ref)
+    {solve, pool} = pop_solve(%SolvePool{pool | running: running}, caller_ref)
+
+    case {solve, reason} do
+      {nil, _reason} ->
+        :ok
+
+      {solve, {:solved, response}} ->
+        GenServer.reply(solve.from, {:ok, response})
+
+      {solve, reason} ->
+        Logger.error("module=#{__MODULE__} event#solve message=Remote solve failed: #{inspect(reason)}")
+        GenServer.reply(solve.from, {:error, reason})
+    end
+
+    {:noreply, next(pool)}
+  end
+
+  def handle_info({:DOWN, ref, :process, _pid, _reason}, %SolvePool{} = pool) do
+    {:noreply, drop(pool, ref)}
+  end
+
+  def handle_info({:solve_timeout, ref}, %SolvePool{} = pool) do
+    {:noreply, drop(pool, ref)}
+  end
+
+  # The solve's result is its exit reason, so the pool only needs the monitor.
+  defp start(%SolvePool{} = pool, caller_ref, model) do
+    cancel = Nif.new_solve_cancel_nif()
+    {_pid, ref} = spawn_monitor(fn -> exit({:solved, Model.solve_serialized(model, cancel)}) end)
+
+    %SolvePool{
+      pool
+      | solves: Map.update!(pool.solves, caller_ref, &%{&1 | cancel: cancel}),
+        running: Map.put(pool.running, ref, caller_ref)
+    }
+  end
+
+  defp next(%SolvePool{} = pool) do
+    case :queue.out(pool.queue) do
+      {{:value, {caller_ref, model}}, queue} -> start(%SolvePool{pool | queue: queue}, caller_ref, model)
+      {:empty, _queue} -> pool
+    end
+  end
+
+  defp pop_solve(%SolvePool{} = pool, caller_ref) do
+    case Map.pop(pool.solves, caller_ref) do
+      {nil, _solves} ->
+        {nil, pool}
+
+      {solve, solves} ->
+        Process.demonitor(caller_ref, [:flush])
+        if solve.timer, do: Process.cancel_timer(solve.timer)
+        {solve, %SolvePool{pool | solves: solves}}
+    end
+  end
+
+  # Give up on the solve of a caller that exited or stopped waiting: cancel it
+  # when it is running, as its solving process still holds a place in the pool
+  # until the solver returns, or take it out of the queue.
+  defp drop(%SolvePool{} = pool, caller_ref) do
+    case pop_solve(pool, caller_ref) do
+      {nil, pool} ->
+        pool
+
+      {%{cancel: nil}, pool} ->
+        %SolvePool{pool | queue: :queue.filter(fn {ref, _model} -> ref != caller_ref end, pool.queue)}
+
+      {%{cancel: cancel}, pool} ->
+        Nif.cancel_solve_nif(cancel)
+        pool
+    end
+  end
+end
@@ -7,7 +7,24 @@ defmodule Exhort.SAT.SolverResponse do
   """
 
   @type t :: %__MODULE__{}
-  defstruct [:res, :model, :status, :int_status, :objective, :walltime, :usertime]
+  defstruct [
+    :res,
+    :model,
+    :status,
+    :int_status,
+    :objective,
+    :best_bound,
+    :objectives,
+    :walltime,
+    :usertime,
+    :deterministic_time,
+    :num_branches,
+    :num_conflicts,
+    :solution_info,
+    :workers,
+    :solutions,
+    :stop_reason
+  ]
 
   alias __MODULE__
   alias Exhort.NIF.Nif
@@ -25,7 +42,7 @@ defmodule Exhort.SAT.SolverResponse do
           "objective" => objective,
           "walltime" => walltime,
           "usertime" => usertime
-        },
+        } = response,
         model
       ) do
     %SolverResponse{
@@ -34,18 +51,66 @@ defmodule Exhort.SAT.SolverResponse do
       status: status_from_int(int_status),
       int_status: int_status,
       objective: objective,
+      best_bound: Map.get(response, "best_bound"),
+      objectives: Map.get(response, "objectives"),
       walltime: walltime,
-      usertime: usertime
+      usertime: usertime,
+      deterministic_time: Map.get(response, "deterministic_time"),
+      num_branches: Map.get(response, "num_branches"),
+      num_conflicts: Map.get(response, "num_conflicts"),
+      solution_info: Map.get(response, "solution_info"),
+      workers: build_workers(Map.get(response, "workers")),
+      solutions: Map.get(response, "solutions"),
+      stop_reason: Map.get(response, "stop_reason")
     }
   end
 
   @doc """
-  A map of the response metadata, `:status`, `:objective`, `:walltime`,
-  `:usertime`.
+  Decode a response returned by `Model.solve_serialized/1`, on another node,
+  for `model`, the model that was serialized. The variables of `model` may
+  then be used to read the values of the response.
+  """
+  @spec deserialize(binary(), Model.t()) :: SolverResponse.t()
+  def deserialize(binary, model) do
+    {:exhort_response, 1, response, stats} = :erlang.binary_to_term(binary, [:safe])
+
+    response
+    |> Nif.decode_response_nif()
+    |> Map.merge(stats)
+    |> build(model)
+  end
+
+  defp build_workers(nil), do: nil
+
+  defp build_workers(workers) do
+    Enum.map(workers, fn worker ->
+      %{
+        name: worker["name"],
+        tasks: worker["tasks"],
+        walltime: worker["walltime"],
+        deterministic_time: worker["deterministic_time"]
+      }
+    end)
+  end
+
+  @doc """
+  A map of the response metadata, `:status`, `:objective`, `:best_bound`,
+  `:walltime`, `:usertime`, `:deterministic_time`, `:num_branches`,
+  `:num_conflicts`, `:stop_reason`.
   """
   @spec stats(SolverResponse.t()) :: map()
   def stats(response) do
-    Map.take(response, [:status, :objective, :walltime, :usertime])
+    Map.take(response, [
+      :status,
+      :objective,
+      :best_bound,
+      :walltime,
+      :usertime,
+      :deterministic_time,
+      :num_branches,
+      :num_conflicts,
+      :stop_reason
+    ])
   end
 
   @doc """
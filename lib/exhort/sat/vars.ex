@@ -6,6 +6,8 @@ defmodule Exhort.SAT.Vars do
 
   alias __MODULE__
 
+  # The variables are listed newest first, so adding one is constant time.
+
   @type t :: %__MODULE__{}
   defstruct list: [], map: %{}
 
@@ -17,7 +19,7 @@ defmodule Exhort.SAT.Vars do
   """
   @spec add(Vars.t(), map()) :: Vars.t()
   def add(%Vars{list: list, map: map} = vars, %{name: name} = var) do
-    %Vars{vars | list: list ++ [var], map: Map.put(map, name, var)}
+    %Vars{vars | list: [var | list], map: Map.put(map, name, var)}
   end
 
   @doc """
@@ -36,5 +38,5 @@ defmodule Exhort.SAT.Vars do
   @doc """
   Provide an ordered list of variables.
   """
-  def iter(%Vars{list: list}), do: list
+  def iter(%Vars{list: list}), do: Enum.reverse(list)
 end
@@ -6,6 +6,7 @@ defmodule Exhort.MixProject do
       app: :exhort,
       version: "0.1.1",
       elixir: "~> 1.13",
+      elixirc_paths: elixirc_paths(Mix.env()),
       start_permanent: Mix.env() == :prod,
       deps: deps(),
       description: description(),
@@ -13,8 +14,9 @@ defmodule Exhort.MixProject do
       name: "Exhort",
       docs: docs(),
       compilers: [:elixir_make] ++ Mix.compilers(),
-      make_args: ["--quiet"],
-      make_clean: ["clean"]
+      make_args: ["--quiet", "-j#{System.schedulers_online()}"],
+      make_clean: ["clean"],
+      aliases: aliases()
     ]
   end
 
@@ -25,6 +27,10 @@ defmodule Exhort.MixProject do
     ]
   end
 
+  # The sample models in test/support are also loaded by the benchmarks.
+  defp elixirc_paths(:test), do: ["lib", "test/support"]
+  defp elixirc_paths(_), do: ["lib"]
+
   # Run "mix help deps" to learn about dependencies.
   defp deps do
     [
@@ -34,6 +40,14 @@ defmodule Exhort.MixProject do
     ]
   end
 
+  defp aliases do
+    [
+      bench: "run bench/samples.exs",
+      "bench.scaling": "run bench/scaling.exs",
+      "bench.instances": "run bench/instances.exs"
+    ]
+  end
+
   defp description() do
     """
     An idiomatic Elixir library for operations research optimization.
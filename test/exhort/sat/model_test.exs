@@ -0,0 +1,707 @@
+defmodule Exhort.SAT.ModelTest do
+  use ExUnit.Case
+  use Exhort.SAT.Builder
+
+  alias Exhort.NIF.Nif
+  alias Exhort.SampleModels
+  alias Exhort.SAT.SolutionFile
+  alias Exhort.SAT.Vars
+
+  defp model do
+    Builder.new()
+    |> Builder.def_int_var("x", {0, 10})
+    |> Builder.def_int_var("y", {0, 10})
+    |> Builder.constrain("x" + "y" == 10)
+    |> Builder.maximize("x")
+    |> Builder.build()
+  end
+
+  test "streams the search log" do
+    response = Model.solve(model(), log: self())
+
+    assert :optimal == response.status
+    assert_receive {:exhort_log, [line | _]}
+    assert is_binary(line)
+  end
+
+  test "does not log by default" do
+    Model.solve(model())
+
+    refute_receive {:exhort_log, _}
+  end
+
+  test "reports the best bound while sending progress" do
+    response = Model.solve(model(), progress: self(), progress_interval: 1)
+
+    assert :optimal == response.status
+    assert 10 == response.best_bound
+
+    assert_receive {:exhort_progress,
+                    %{"objective" => objective, "best_bound" => bound, "walltime" => walltime}}
+
+    assert is_float(objective) or is_nil(objective)
+    assert is_float(bound) or is_nil(bound)
+    assert is_float(walltime) and walltime >= 0
+  end
+
+  test "stops when no solution improves within the timeout" do
+    response =
+      SampleModels.golomb_ruler()
+      |> Builder.build()
+      |> Model.solve(no_improvement_timeout: 0.5, time_limit: 60)
+
+    assert :unknown == response.status
+    assert :no_improvement == response.stop_reason
+    assert response.walltime < 60
+  end
+
+  test "stops within the gap limit" do
+    response = Model.solve(model(), relative_gap_limit: 1.0)
+
+    assert response.status in [:feasible, :optimal]
+  end
+
+  # The seed is a feasible but poor solution of the same variables: solved with
+  # `x` held low and `z` fixed to 1.
+  defp improve_model(seed? \\ false) do
+    builder =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 10})
+      |> Builder.def_int_var("y", {0, 10})
+      |> Builder.def_int_var("z", {0, 5})
+      |> Builder.constrain("x" + "y" == 10)
+      |> Builder.maximize("x" + "z")
+
+    if seed? do
+      builder
+      |> Builder.constrain("x" <= 2)
+      |> Builder.constrain("z" == 1)
+      |> Builder.build()
+    else
+      Builder.build(builder)
+    end
+  end
+
+  test "improves a poor response with random neighbourhoods" do
+    seed = Model.solve(improve_model(true))
+    assert 3 == seed.objective
+
+    improved = Model.improve(improve_model(), seed, {:random, 0.7}, iterations: 20, seed: 1)
+
+    assert :feasible == improved.status
+    assert improved.objective > seed.objective
+  end
+
+  test "improves a poor response with variable groups" do
+    seed = Model.solve(improve_model(true))
+    assert 3 == seed.objective
+
+    improved = Model.improve(improve_model(), seed, {:groups, [["x", "y"]]}, iterations: 1)
+
+    # Only `x` and `y` are searched, so `z` keeps its value in the seed.
+    assert :feasible == improved.status
+    assert 11 == improved.objective
+    assert 10 == SolverResponse.int_val(improved, "x")
+    assert 1 == SolverResponse.int_val(improved, "z")
+  end
+
+  test "reports each improvement with the time since the loop started" do
+    seed = Model.solve(improve_model(true))
+    Model.improve(improve_model(), seed, {:groups, [["x", "y"]]}, iterations: 1, progress: self())
+
+    assert_receive {:exhort_improve, %{"iteration" => 1, "objective" => 11.0, "walltime" => walltime}}
+    assert is_float(walltime) and walltime > 0
+  end
+
+  test "optimizes objectives lexicographically" do
+    response =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 10})
+      |> Builder.def_int_var("y", {0, 10})
+      |> Builder.constrain("x" + "y" <= 12)
+      |> Builder.maximize("x")
+      |> Builder.maximize("y")
+      |> Builder.build()
+      |> Model.solve()
+
+    assert :optimal == response.status
+    assert [10, 2] == response.objectives
+    assert 10 == SolverResponse.int_val(response, "x")
+    assert 2 == SolverResponse.int_val(response, "y")
+  end
+
+  test "rejects several objectives outside of solve/2" do
+    model =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 10})
+      |> Builder.def_int_var("y", {0, 10})
+      |> Builder.maximize("x")
+      |> Builder.maximize("y")
+      |> Builder.build()
+
+    assert_raise ArgumentError, fn -> Model.solve(model, fn _response, acc -> acc end) end
+    assert_raise ArgumentError, fn -> Model.solution_pool(model) end
+    assert_raise ArgumentError, fn -> Model.presolve(model) end
+    assert_raise ArgumentError, fn -> Model.serialize(model) end
+  end
+
+  test "relaxes an objective within its tolerance" do
+    response =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 10})
+      |> Builder.def_int_var("y", {0, 10})
+      |> Builder.constrain("x" + "y" <= 12)
+      |> Builder.maximize("x", tolerance: 2)
+      |> Builder.maximize("y")
+      |> Builder.build()
+      |> Model.solve()
+
+    assert [10, 4] == response.objectives
+    assert 8 == SolverResponse.int_val(response, "x")
+  end
+
+  test "keeps 64-bit bounds and coefficients" do
+    response =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 10_000_000_000})
+      |> Builder.def_int_var("y", {0, 10})
+      |> Builder.constrain("x" == 3_000_000_000 * "y")
+      |> Builder.maximize("x")
+      |> Builder.build()
+      |> Model.solve()
+
+    assert :optimal == response.status
+    assert 9_000_000_000 == SolverResponse.int_val(response, "x")
+  end
+
+  test "accepts variables as packed model indexes" do
+    model =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 2})
+      |> Builder.def_int_var("y", {0, 2})
+      |> Builder.def_int_var("z", {0, 2})
+      |> Builder.maximize("x" + "y" + "z")
+      |> Builder.build()
+
+    packed = for index <- [0, 1, 2], into: <<>>, do: <<index::signed-native-32>>
+    Nif.add_all_different_nif(model.res, packed)
+
+    response = Model.solve(model)
+    assert :optimal == response.status
+    assert 3 == response.objective
+
+    assert_raise ArgumentError, fn ->
+      Nif.add_all_different_nif(model.res, <<3::signed-native-32>>)
+    end
+  end
+
+  test "rejects variables of another model" do
+    model =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 2})
+      |> Builder.build()
+
+    other =
+      Builder.new()
+      |> Builder.def_int_var("a", {0, 2})
+      |> Builder.def_int_var("b", {0, 2})
+      |> Builder.build()
+
+    b = Vars.get(other.vars, "b").res
+    assert_raise ArgumentError, fn -> Nif.solution_pool_nif(model.res, [b], %{}) end
+    assert_raise ArgumentError, fn -> Nif.enumerate_to_file_nif(model.res, "unused", [b], %{}) end
+  end
+
+  # Longer than the timeslice of a NIF call, so the constraint is added on a
+  # dirty scheduler.
+  test "adds constraints over lists longer than a timeslice" do
+    builder = Builder.def_int_var(Builder.new(), "x", {0, 10})
+    x = Map.get(builder.vars.map, "x")
+    offsets = Enum.map(0..99_999, &LinearExpression.sum(&1, x))
+
+    response =
+      builder
+      |> Builder.constrain_list(:"all!=", offsets)
+      |> Builder.maximize("x")
+      |> Builder.build()
+      |> Model.solve()
+
+    assert :optimal == response.status
+    assert 10 == SolverResponse.int_val(response, "x")
+  end
+
+  test "builds blocks concurrently and merges them" do
+    blocks =
+      for i <- 1..4 do
+        Builder.new()
+        |> Builder.def_int_var("x#{i}", {0, 10 - i})
+        |> Builder.constrain("total", :<=, "x#{i}")
+      end
+
+    response =
+      Builder.new()
+      |> Builder.def_int_var("total", {0, 10})
+      |> Builder.maximize("total")
+      |> Builder.build(blocks)
+      |> Model.solve()
+
+    assert :optimal == response.status
+    assert 6 == SolverResponse.int_val(response, "total")
+    assert 6 == SolverResponse.int_val(response, "x4")
+  end
+
+  test "merges a block only into its parent, once" do
+    model = Builder.build(Builder.new())
+    other = Builder.build(Builder.new())
+    block = Nif.new_sub_builder_nif(model.res)
+
+    assert_raise ArgumentError, fn -> Nif.merge_builders_nif(other.res, [{block, []}]) end
+    assert_raise ArgumentError, fn -> Nif.merge_builders_nif(model.res, [{block, []}, {block, []}]) end
+    assert [[]] == Nif.merge_builders_nif(model.res, [{block, []}])
+    assert_raise ArgumentError, fn -> Nif.merge_builders_nif(model.res, [{block, []}]) end
+  end
+
+  test "keeps the negated literals of a block in the block" do
+    model =
+      Builder.new()
+      |> Builder.def_bool_var("b")
+      |> Builder.maximize("b")
+      |> Builder.build()
+
+    variables = Model.profile(model).variables
+    block = Nif.new_sub_builder_nif(model.res)
+    not_b = Nif.bool_not_nif(Vars.get(model.vars, "b").res)
+    Nif.add_allowed_assignments_nif(block, [not_b], <<1::signed-native-64>>)
+
+    assert variables == Model.profile(model).variables
+
+    Nif.merge_builders_nif(model.res, [{block, []}])
+    response = Model.solve(model)
+
+    assert :optimal == response.status
+    refute SolverResponse.bool_val(response, "b")
+  end
+
+  test "constrains variables to tables of tuples" do
+    packed = for value <- [0, 1, 1, 2, 2, 3, 3, 0], into: <<>>, do: <<value::signed-native-64>>
+
+    response =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 3})
+      |> Builder.def_int_var("y", {0, 3})
+      |> Builder.constrain_list(:allowed_assignments, ["x", "y"], tuples: packed)
+      |> Builder.constrain_list(:forbidden_assignments, ["x", "y"], tuples: [{3, 0}])
+      |> Builder.maximize(10 * "x" + "y")
+      |> Builder.build()
+      |> Model.solve()
+
+    assert :optimal == response.status
+    assert 2 == SolverResponse.int_val(response, "x")
+    assert 3 == SolverResponse.int_val(response, "y")
+  end
+
+  test "checks cumulative constraints before adding them" do
+    builder =
+      Builder.new()
+      |> Builder.def_int_var("s", {0, 10})
+      |> Builder.def_bool_var("b")
+      |> Builder.def_fixed_interval_var("i", "s", 2)
+      |> Builder.constrain_list(:cumulative, [{"i", 1}], capacity: 1)
+
+    model = Builder.build(builder)
+    other = Builder.build(builder)
+    [%Constraint{res: cumulative}] = model.constraints
+    interval = Vars.get(model.vars, "i").res
+    constraints = Model.profile(model).constraints
+
+    assert_raise ArgumentError, fn -> Nif.add_cumulative_nif(model.res, 1, [interval], <<>>) end
+    assert constraints == Model.profile(model).constraints
+
+    assert_raise ArgumentError, fn ->
+      Nif.add_cumulative_demands_nif(other.res, cumulative, [interval], <<1::signed-native-64>>)
+    end
+
+    assert_raise ArgumentError, fn ->
+      builder
+      |> Builder.constrain_list(:cumulative, [{"i", 1}], capacity: 1, if: "b")
+      |> Builder.build()
+    end
+  end
+
+  test "imports an OPB instance" do
+    opb = """
+    * #variable= 3 #constraint= 2
+    min: +1 x1 +2 x2 +3 x3 ;
+    +1 x1 +1 x2 >= 1 ;
+    +1 x2 +1 ~x3
+      >= 2 ;
+    """
+
+    {:ok, model} = Model.from_binary(opb, :opb)
+    response = Model.solve(model)
+
+    assert :optimal == response.status
+    assert 2 == response.objective
+    assert true == SolverResponse.bool_val(response, "x2")
+    assert false == SolverResponse.bool_val(response, "x3")
+
+    assert {:error, {:parse, 1, "non-linear terms are not supported"}} =
+             Model.from_binary("min: 1 x1 x2 ;", :opb)
+  end
+
+  @tag :tmp_dir
+  test "imports an MPS file", %{tmp_dir: tmp_dir} do
+    path = Path.join(tmp_dir, "model.mps")
+
+    File.write!(path, """
+    NAME          TEST
+    OBJSENSE
+        MAX
+    ROWS
+     N  obj
+     L  c1
+    COLUMNS
+        MARKER                 'MARKER'                 'INTORG'
+        x         obj       1   c1        1
+        y         obj       2   c1        1
+        MARKER                 'MARKER'                 'INTEND'
+    RHS
+        rhs       c1        4
+    BOUNDS
+     UP bnd       x         3
+     UP bnd       y         1
+    ENDATA
+    """)
+
+    {:ok, model} = Model.from_file(path, :mps)
+    response = Model.solve(model)
+
+    assert :optimal == response.status
+    assert 5 == response.objective
+    assert 3 == SolverResponse.int_val(response, "x")
+    assert {:error, :enoent} == Model.from_file(Path.join(tmp_dir, "missing.mps"), :mps)
+  end
+
+  test "limits huge MPS bounds and rejects duplicate variables" do
+    mps = """
+    OBJSENSE
+        MAX
+    ROWS
+     N  obj
+    COLUMNS
+        MARKER                 'MARKER'                 'INTORG'
+        x         obj       1
+        MARKER                 'MARKER'                 'INTEND'
+    BOUNDS
+     UP bnd       x         1e20
+     LO bnd       x         -1e20
+    ENDATA
+    """
+
+    {:ok, model} = Model.from_binary(mps, :mps)
+    response = Model.solve(model)
+
+    assert :optimal == response.status
+    assert 10_000_000 == SolverResponse.int_val(response, "x")
+
+    duplicate = """
+    ROWS
+     N  obj
+    COLUMNS
+        x         obj       1
+        y         obj       1
+        x         obj       1
+    ENDATA
+    """
+
+    assert {:error, {:parse, 6, "duplicate variable x"}} = Model.from_binary(duplicate, :mps)
+  end
+
+  test "solves a serialized model and decodes the response" do
+    model = model()
+
+    response =
+      model
+      |> Model.serialize(time_limit: 5)
+      |> Model.solve_serialized()
+      |> SolverResponse.deserialize(model)
+
+    assert :optimal == response.status
+    assert 10 == SolverResponse.int_val(response, "x")
+    assert 0 == SolverResponse.int_val(response, "y")
+  end
+
+  test "rejects serializing a presolved model" do
+    assert_raise ArgumentError, fn -> model() |> Model.presolve() |> Model.serialize() end
+  end
+
+  test "solves within a memory budget" do
+    response = Model.solve(model(), max_memory_in_mb: 1024)
+
+    assert :optimal == response.status
+    assert nil == response.stop_reason
+  end
+
+  test "stops once over the memory budget" do
+    # The variables alone take more than the 1 MB budget, and the infeasible
+    # ruler keeps the search running until the monitor stops it.
+    builder = Enum.reduce(1..50_000, SampleModels.golomb_ruler(), &Builder.def_int_var(&2, "pad#{&1}", {0, 10}))
+
+    response =
+      builder
+      |> Builder.build()
+      |> Model.solve(max_memory_in_mb: 1, time_limit: 60)
+
+    assert :memory_limit == response.stop_reason
+    assert response.walltime < 60
+  end
+
+  test "reports the native memory of builders and responses" do
+    model = model()
+    response = Model.solve(model)
+
+    memory = Exhort.NativeMemory.report()
+
+    assert memory.builders > 0
+    assert memory.responses > 0
+    assert memory.rss >= 0
+    assert :optimal == response.status
+  end
+
+  test "counts the native resources" do
+    before = Exhort.NativeMemory.resources()
+
+    model = model()
+    response = Model.solve(model)
+
+    resources = Exhort.NativeMemory.resources()
+
+    assert resources.builders.allocated >= before.builders.allocated + 1
+    assert resources.int_vars.allocated >= before.int_vars.allocated + 2
+    assert resources.constraints.allocated > before.constraints.allocated
+    assert resources.responses.live >= 1
+    assert resources.builders.bytes > 0
+    assert :optimal == response.status
+  end
+
+  test "presolves once and solves with different objectives" do
+    model = Model.presolve(model())
+
+    response = Model.solve(model)
+    assert :optimal == response.status
+    assert 10 == SolverResponse.int_val(response, "x")
+
+    response = Model.solve(model, objective: {:maximize, LinearExpression.terms([{1, "y"}])})
+    assert :optimal == response.status
+    assert 10 == SolverResponse.int_val(response, "y")
+    assert 0 == SolverResponse.int_val(response, "x")
+
+    response = Model.solve(model, objective: {:minimize, "y"}, time_limit: 5)
+    assert 0 == SolverResponse.int_val(response, "y")
+  end
+
+  test "keeps the domains the presolve tightened" do
+    model =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 10})
+      |> Builder.def_int_var("y", {0, 10})
+      |> Builder.constrain("x" + "y" == 10)
+      |> Builder.constrain("x" >= 10)
+      |> Builder.maximize("y")
+      |> Builder.build()
+      |> Model.presolve()
+
+    assert [{10, 10}] == Model.presolved_domain(model, "x")
+    assert [{0, 0}] == Model.presolved_domain(model, "y")
+
+    response = Model.solve(model)
+    assert :optimal == response.status
+    assert 0 == response.objective
+  end
+
+  test "still runs the solver's presolve on a presolved model" do
+    Model.solve(Model.presolve(model()), log: self())
+    assert Enum.any?(receive_log(), &(&1 =~ "Starting presolve"))
+  end
+
+  defp receive_log(lines \\ []) do
+    receive do
+      {:exhort_log, more} -> receive_log(lines ++ more)
+    after
+      100 -> lines
+    end
+  end
+
+  test "profiles the model formulation" do
+    profile =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 10})
+      |> Builder.def_int_var("y", {0, 1_000})
+      |> Builder.def_bool_var("b")
+      |> Builder.constrain("x" + "y" == 10, if: "b")
+      |> Builder.constrain("x" <= 5)
+      |> Builder.maximize("x")
+      |> Builder.build()
+      |> Model.profile(top: 1)
+
+    assert 3 == profile.variables
+    assert %{small: 1, medium: 1, boolean: 1} = profile.domains
+    assert %{count: 2, max_terms: 2, enforced: 1} = profile.constraints.linear
+    assert %{0 => 1, 1 => 1} == profile.enforcement
+    assert 1 == profile.objective_terms
+    assert profile.memory > 0
+    assert [%{type: :linear, terms: 2, enforcement: 1}] = profile.largest_constraints
+  end
+
+  # A knapsack, which the presolve alone does not solve, so the workers search.
+  defp knapsack_model do
+    items = Enum.zip([48, 30, 42, 36, 36, 48, 42, 42, 36, 24], [10, 30, 25, 50, 35, 30, 15, 40, 30, 35])
+
+    builder =
+      items
+      |> Enum.with_index()
+      |> Enum.reduce(Builder.new(), fn {_item, i}, builder -> Builder.def_bool_var(builder, "x#{i}") end)
+
+    weight = for {{weight, _}, i} <- Enum.with_index(items), do: LinearExpression.prod("x#{i}", weight)
+    value = for {{_, value}, i} <- Enum.with_index(items), do: LinearExpression.prod("x#{i}", value)
+    weight = LinearExpression.sum(weight)
+
+    builder
+    |> Builder.constrain(weight <= 150)
+    |> Builder.maximize(LinearExpression.sum(value))
+    |> Builder.build()
+  end
+
+  test "solves deterministically and reports the workers" do
+    first = Model.solve(knapsack_model(), deterministic: true, seed: 7, num_workers: 2)
+    second = Model.solve(knapsack_model(), deterministic: true, seed: 7, num_workers: 2)
+
+    assert :optimal == first.status
+    assert first.deterministic_time == second.deterministic_time
+    assert first.num_branches == second.num_branches
+
+    assert [_ | _] = first.workers
+
+    for worker <- first.workers do
+      assert %{name: name, tasks: tasks, walltime: walltime, deterministic_time: dtime} = worker
+      assert is_binary(name) and name != ""
+      assert is_integer(tasks) and tasks >= 0
+      assert is_float(walltime) and walltime >= 0
+      assert is_float(dtime) and dtime >= 0
+    end
+
+    assert Enum.map(first.workers, & &1.name) == Enum.map(second.workers, & &1.name)
+  end
+
+  @tag :tmp_dir
+  test "enumerates solutions to a file", %{tmp_dir: tmp_dir} do
+    path = Path.join(tmp_dir, "solutions.bin")
+
+    {:ok, response, file} =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 3})
+      |> Builder.def_int_var("y", {0, 3})
+      |> Builder.constrain("x" + "y" == 3)
+      |> Builder.build()
+      |> Model.enumerate_to_file(path, ["x", "y"])
+
+    assert 4 == response.solutions
+    assert 4 == file.rows
+    assert :int64 == file.format
+
+    solutions = Enum.to_list(SolutionFile.stream(file, 3))
+    assert [[0, 3], [1, 2], [2, 1], [3, 0]] == Enum.sort(solutions)
+    assert Enum.at(solutions, 2) == SolutionFile.get(file, 2)
+    assert %{"x" => x, "y" => y} = SolutionFile.to_map(file, 1)
+    assert 3 == x + y
+  end
+
+  @tag :tmp_dir
+  test "replaces a solution file that is still open", %{tmp_dir: tmp_dir} do
+    path = Path.join(tmp_dir, "solutions.bin")
+
+    model =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 3})
+      |> Builder.build()
+
+    {:ok, _response, first} = Model.enumerate_to_file(model, path, ["x"])
+    {:ok, _response, second} = Model.enumerate_to_file(model, path, ["x"], max_solutions: 2)
+
+    assert 4 == first.rows
+    assert 4 == length(SolutionFile.read(first, 0, 10))
+    assert 2 == second.rows
+    assert [path] == Path.wildcard(Path.join(tmp_dir, "*"))
+  end
+
+  @tag :tmp_dir
+  test "enumerates boolean solutions as bitsets", %{tmp_dir: tmp_dir} do
+    path = Path.join(tmp_dir, "solutions.bin")
+
+    {:ok, response, file} =
+      Builder.new()
+      |> Builder.def_bool_var("a")
+      |> Builder.def_bool_var("b")
+      |> Builder.build()
+      |> Model.enumerate_to_file(path, ["a", "b"], max_solutions: 3)
+
+    assert 3 == response.solutions
+    assert :bitset == file.format
+    assert 3 == length(Enum.uniq(SolutionFile.read(file, 0, 10)))
+  end
+
+  @tag :tmp_dir
+  test "enumerates solutions without projected variables", %{tmp_dir: tmp_dir} do
+    path = Path.join(tmp_dir, "solutions.bin")
+
+    {:ok, _response, file} =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 3})
+      |> Builder.build()
+      |> Model.enumerate_to_file(path, [])
+
+    assert 4 == file.rows
+    assert [] == SolutionFile.get(file, 3)
+    assert [[], []] == SolutionFile.read(file, 2, 10)
+    assert 4 == Enum.count(SolutionFile.stream(file, 3))
+  end
+
+  test "finds a pool of diverse solutions" do
+    model =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 10})
+      |> Builder.def_int_var("y", {0, 10})
+      |> Builder.constrain("x" + "y" <= 10)
+      |> Builder.maximize("x" + 2 * "y")
+      |> Builder.build()
+
+    {response, pool} = Model.solution_pool(model, k: 3, min_distance: 2)
+
+    assert :optimal == response.status
+    assert 3 == length(pool)
+    assert [%{objective: 20.0, values: %{"x" => 0, "y" => 10}} | _] = pool
+
+    objectives = Enum.map(pool, & &1.objective)
+    assert objectives == Enum.sort(objectives, :desc)
+    assert Enum.uniq(pool) == pool
+
+    for a <- pool, b <- pool, a != b do
+      assert a.values["x"] != b.values["x"] and a.values["y"] != b.values["y"]
+    end
+  end
+
+  test "re-solves for distinct solutions" do
+    model =
+      Builder.new()
+      |> Builder.def_int_var("x", {0, 2})
+      |> Builder.def_int_var("y", {0, 2})
+      |> Builder.maximize("x")
+      |> Builder.build()
+
+    {_response, pool} = Model.solution_pool(model, k: 9, vars: ["x", "y"])
+
+    assert 9 == length(pool)
+    assert Enum.uniq(pool) == pool
+    assert Enum.uniq_by(pool, & &1.values) == pool
+  end
+end
@@ -0,0 +1,84 @@
+defmodule Exhort.SAT.SolvePoolTest do
+  use ExUnit.Case
+  use Exhort.SAT.Builder
+
+  alias Exhort.SampleModels
+  alias Exhort.SAT.SolvePool
+
+  @moduletag :distributed
+
+  setup_all do
+    System.cmd("epmd", ["-daemon"])
+
+    unless Node.alive?() do
+      {:ok, _} = Node.start(:"exhort_test@127.0.0.1", :longnames)
+    end
+
+    nodes =
+      for _ <- 1..2 do
+        {:ok, _peer, node} =
+          :peer.start_link(%{
+            name: :peer.random_name(),
+            host: ~c"127.0.0.1",
+            longnames: true,
+            args: [~c"-setcookie", Atom.to_charlist(Node.get_cookie())]
+          })
+
+        :ok = :erpc.call(node, :code, :add_paths, [:code.get_path()])
+        {:ok, _} = :erpc.call(node, Application, :ensure_all_started, [:exhort])
+        {:ok, _} = :erpc.call(node, SolvePool, :start_link, [[max_concurrency: 1]])
+        node
+      end
+
+    %{nodes: nodes}
+  end
+
+  defp model(n) do
+    Builder.new()
+    |> Builder.def_int_var("x", {0, n})
+    |> Builder.def_int_var("y", {0, n})
+    |> Builder.def_bool_var("b")
+    |> Builder.constrain("x" + "y" == n, if: "b")
+    |> Builder.maximize("x" + "b")
+    |> Builder.build()
+  end
+
+  test "solves local models on remote nodes", %{nodes: nodes} do
+    model = model(10)
+
+    for node <- nodes do
+      response = SolvePool.solve({SolvePool, node}, model, time_limit: 5)
+
+      assert :optimal == response.status
+      assert 11 == response.objective
+      assert 10 == SolverResponse.int_val(response, "x")
+      assert true == SolverResponse.bool_val(response, "b")
+    end
+  end
+
+  test "queues the solves beyond the pool's concurrency", %{nodes: [node | _]} do
+    responses =
+      1..4
+      |> Enum.map(fn n -> {n, Task.async(fn -> SolvePool.solve({SolvePool, node}, model(n)) end)} end)
+      |> Enum.map(fn {n, task} -> {n, Task.await(task, :infinity)} end)
+
+    for {n, response} <- responses do
+      assert n == SolverResponse.int_val(response, "x")
+    end
+  end
+
+  test "cancels the solve of a caller that stops waiting", %{nodes: [_, node]} do
+    model = Builder.build(SampleModels.golomb_ruler())
+
+    assert {:timeout, _} =
+             catch_exit(SolvePool.solve({SolvePool, node}, model, time_limit: 60, timeout: 500))
+
+    # The pool solves one model at a time, so this waits for the cancelled
+    # solve to return.
+    started = System.monotonic_time(:millisecond)
+    response = SolvePool.solve({SolvePool, node}, model(10), time_limit: 5)
+
+    assert :optimal == response.status
+    assert System.monotonic_time(:millisecond) - started < 30_000
+  end
+end
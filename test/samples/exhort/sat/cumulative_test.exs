@@ -0,0 +1,45 @@
+defmodule Samples.Exhort.SAT.Cumulative do
+  use ExUnit.Case
+  use Exhort.SAT.Builder
+
+  test "cumulative" do
+    # task = {name, duration, demand}, sharing a resource of capacity 2.
+    tasks = [{"a", 3, 2}, {"b", 2, 1}, {"c", 2, 1}, {"d", 1, 1}]
+    horizon = tasks |> Enum.map(&elem(&1, 1)) |> Enum.sum()
+
+    builder =
+      Enum.reduce(tasks, Builder.new(), fn {name, duration, _demand}, builder ->
+        builder
+        |> Builder.def_int_var("start_#{name}", {0, horizon - duration})
+        |> Builder.def_fixed_interval_var("interval_#{name}", "start_#{name}", duration)
+        |> Builder.constrain("makespan" >= "start_#{name}" + duration)
+      end)
+
+    response =
+      builder
+      |> Builder.def_int_var("makespan", {0, horizon})
+      |> Builder.constrain_list(
+        :cumulative,
+        Enum.map(tasks, fn {name, _duration, demand} -> {"interval_#{name}", demand} end),
+        capacity: 2
+      )
+      |> Builder.minimize("makespan")
+      |> Builder.build()
+      |> Model.solve()
+
+    assert :optimal == response.status
+    assert 6 == response.objective
+
+    for t <- 0..(horizon - 1) do
+      load =
+        for {name, duration, demand} <- tasks,
+            start = SolverResponse.int_val(response, "start_#{name}"),
+            t >= start and t < start + duration,
+            reduce: 0 do
+          load -> load + demand
+        end
+
+      assert load <= 2
+    end
+  end
+end
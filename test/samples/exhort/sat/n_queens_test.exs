@@ -2,53 +2,21 @@ defmodule Samples.Exhort.SAT.NQueens do
   use ExUnit.Case
   use Exhort.SAT.Builder
 
+  alias Exhort.SampleModels
+
   test "n-queens" do
     board_size = 4
-    columns = 0..(board_size - 1)
-
-    acc = %{
-      builder: Builder.new(),
-      queens: []
-    }
-
-    %{
-      builder: builder,
-      queens: queens
-    } =
-      Enum.reduce(columns, acc, fn column, %{builder: builder, queens: queens} = acc ->
-        queen = "queen_#{column}"
-        queens = queens ++ [queen]
-
-        builder =
-          builder
-          |> Builder.def_int_var(queen, {0, board_size - 1})
-          |> Builder.def_constant("#{column}", column)
-
-        %{acc | builder: builder, queens: queens}
-      end)
-
-    builder = Builder.constrain_list(builder, :"all!=", queens)
 
-    builder =
-      Enum.reduce(columns, [], fn column, constraints = _acc ->
-        queen = Map.get(builder.vars.map, "queen_#{column}")
-        desc_diagonal = LinearExpression.sum(column, queen)
-        constraints ++ [desc_diagonal]
-      end)
-      |> then(&Builder.constrain_list(builder, :"all!=", &1))
+    response =
+      board_size
+      |> SampleModels.n_queens()
+      |> Builder.build()
+      |> Model.solve()
 
-    builder =
-      Enum.reduce(columns, [], fn column, constraints = _acc ->
-        queen = Map.get(builder.vars.map, "queen_#{column}")
-        asc_diagonal = LinearExpression.minus(column, queen)
-        constraints ++ [asc_diagonal]
-      end)
-      |> then(&Builder.constrain_list(builder, :"all!=", &1))
+    assert :optimal == response.status
 
-    assert :optimal ==
-             builder
-             |> Builder.build()
-             |> Model.solve()
-             |> then(& &1.status)
+    queens =
+      for column <- 0..(board_size - 1), do: SolverResponse.int_val(response, "queen_#{column}")
+    assert Enum.sort(queens) == Enum.to_list(0..(board_size - 1))
   end
 end
@@ -0,0 +1,85 @@
+defmodule Samples.Exhort.SAT.Routing do
+  use ExUnit.Case
+  use Exhort.SAT.Builder
+
+  alias Exhort.SampleModels
+
+  # Node 0 is the depot.
+  @points [{0, 0}, {2, 6}, {5, 3}, {8, 7}, {6, 0}, {1, 3}]
+
+  defp distance(i, j) do
+    {xi, yi} = Enum.at(@points, i)
+    {xj, yj} = Enum.at(@points, j)
+    abs(xi - xj) + abs(yi - yj)
+  end
+
+  defp arcs, do: SampleModels.routing_arcs(length(@points))
+
+  defp def_arcs(builder) do
+    Enum.reduce(arcs(), builder, fn {i, j}, builder ->
+      Builder.def_bool_var(builder, "x_#{i}_#{j}")
+    end)
+  end
+
+  defp minimize_distance(builder) do
+    distance = Enum.map(arcs(), fn {i, j} -> LinearExpression.prod("x_#{i}_#{j}", distance(i, j)) end)
+    Builder.minimize(builder, LinearExpression.sum(distance))
+  end
+
+  defp tour(response) do
+    next =
+      for {i, j} <- arcs(), SolverResponse.bool_val(response, "x_#{i}_#{j}"), into: %{}, do: {i, j}
+
+    0 |> Stream.iterate(&Map.fetch!(next, &1)) |> Enum.take(length(@points))
+  end
+
+  # The tours are the shared sample models the benchmarks also solve.
+  test "travelling salesman with a circuit constraint" do
+    response =
+      @points
+      |> SampleModels.routing_circuit()
+      |> Builder.build()
+      |> Model.solve()
+
+    assert :optimal == response.status
+    assert 32 == response.objective
+    assert Enum.sort(tour(response)) == Enum.to_list(0..(length(@points) - 1))
+  end
+
+  test "travelling salesman with MTZ subtour elimination" do
+    response =
+      @points
+      |> SampleModels.routing_mtz()
+      |> Builder.build()
+      |> Model.solve()
+
+    assert :optimal == response.status
+    assert 32 == response.objective
+    assert Enum.sort(tour(response)) == Enum.to_list(0..(length(@points) - 1))
+  end
+
+  test "vehicle routing with a multiple circuit constraint" do
+    vehicles = 2
+    routes = LinearExpression.sum(for {0, j} <- arcs(), do: "x_0_#{j}")
+
+    response =
+      Builder.new()
+      |> def_arcs()
+      |> Builder.constrain_list(
+        :multiple_circuit,
+        Enum.map(arcs(), fn {i, j} -> {i, j, "x_#{i}_#{j}"} end)
+      )
+      |> Builder.constrain(routes == vehicles)
+      |> minimize_distance()
+      |> Builder.build()
+      |> Model.solve()
+
+    assert :optimal == response.status
+    assert 40 == response.objective
+
+    for node <- 1..(length(@points) - 1) do
+      leaving = for {^node, j} <- arcs(), SolverResponse.bool_val(response, "x_#{node}_#{j}"), do: j
+      assert 1 == length(leaving)
+    end
+  end
+end
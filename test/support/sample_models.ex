@@ -0,0 +1,306 @@
+defmodule Exhort.SampleModels do
+  @moduledoc false
+
+  # The models of the sample tests, which the benchmarks also solve, and the
+  # models of tests that need a long search, each returned as an unbuilt
+  # `%Builder{}`.
+
+  use Exhort.SAT.Builder
+
+  def n_queens(board_size \\ 16) do
+    columns = 0..(board_size - 1)
+    queens = Enum.map(columns, &"queen_#{&1}")
+
+    builder =
+      Enum.reduce(queens, Builder.new(), fn queen, builder ->
+        Builder.def_int_var(builder, queen, {0, board_size - 1})
+      end)
+
+    builder = Builder.constrain_list(builder, :"all!=", queens)
+
+    desc = Enum.map(columns, &LinearExpression.sum(&1, Map.get(builder.vars.map, "queen_#{&1}")))
+    asc = Enum.map(columns, &LinearExpression.minus(&1, Map.get(builder.vars.map, "queen_#{&1}")))
+
+    builder
+    |> Builder.constrain_list(:"all!=", desc)
+    |> Builder.constrain_list(:"all!=", asc)
+  end
+
+  def job_shop do
+    jobs_data = [
+      [{0, 3}, {1, 2}, {2, 2}],
+      [{0, 2}, {2, 1}, {1, 4}],
+      [{1, 4}, {2, 3}]
+    ]
+
+    horizon = jobs_data |> List.flatten() |> Enum.map(&elem(&1, 1)) |> Enum.sum()
+
+    tasks =
+      for {job, job_id} <- Enum.with_index(jobs_data),
+          {{machine, duration}, task_id} <- Enum.with_index(job) do
+        {job_id, task_id, machine, duration}
+      end
+
+    task_vars =
+      Enum.flat_map(tasks, fn {job_id, task_id, _machine, duration} ->
+        suffix = "#{job_id}_#{task_id}"
+
+        [
+          IntVar.new("start_#{suffix}", {0, horizon}),
+          IntVar.new("end_#{suffix}", {0, horizon}),
+          IntervalVar.new("interval_#{suffix}", "start_#{suffix}", duration, "end_#{suffix}")
+        ]
+      end)
+
+    machine_constraints =
+      tasks
+      |> Enum.group_by(&elem(&1, 2), fn {job_id, task_id, _, _} -> "interval_#{job_id}_#{task_id}" end)
+      |> Enum.map(fn {_machine, intervals} -> Constraint.no_overlap(intervals) end)
+
+    precedences =
+      for {job_id, task_id, _, _} <- tasks, task_id > 0 do
+        next_start = "start_#{job_id}_#{task_id}"
+        previous_end = "end_#{job_id}_#{task_id - 1}"
+        Constraint.new(next_start >= previous_end)
+      end
+
+    last_ends =
+      jobs_data
+      |> Enum.with_index()
+      |> Enum.map(fn {job, job_id} -> "end_#{job_id}_#{length(job) - 1}" end)
+
+    Builder.new()
+    |> Builder.add(task_vars)
+    |> Builder.add(machine_constraints)
+    |> Builder.add(precedences)
+    |> Builder.def_int_var("makespan", {0, horizon})
+    |> Builder.max_equality("makespan", last_ends)
+    |> Builder.minimize("makespan")
+  end
+
+  def nurse_scheduling do
+    all_nurses = 1..5
+    all_shifts = 1..3
+    all_days = 1..7
+
+    shift_requests = [
+      [[0, 0, 1], [0, 0, 0], [0, 0, 0], [0, 0, 0], [0, 0, 1], [0, 1, 0], [0, 0, 1]],
+      [[0, 0, 0], [0, 0, 0], [0, 1, 0], [0, 1, 0], [1, 0, 0], [0, 0, 0], [0, 0, 1]],
+      [[0, 1, 0], [0, 1, 0], [0, 0, 0], [1, 0, 0], [0, 0, 0], [0, 1, 0], [0, 0, 0]],
+      [[0, 0, 1], [0, 0, 0], [1, 0, 0], [0, 1, 0], [0, 0, 0], [1, 0, 0], [0, 0, 0]],
+      [[0, 0, 0], [0, 0, 1], [0, 1, 0], [0, 0, 0], [1, 0, 0], [0, 1, 0], [0, 0, 0]]
+    ]
+
+    shift = fn nurse, day, shift -> "shift_#{nurse}_#{day}_#{shift}" end
+
+    shift_vars =
+      for n <- all_nurses, d <- all_days, s <- all_shifts, do: BoolVar.new(shift.(n, d, s))
+
+    one_nurse_per_shift =
+      for d <- all_days, s <- all_shifts do
+        Constraint.new(sum(for n <- all_nurses, do: shift.(n, d, s)) == 1)
+      end
+
+    one_shift_per_day =
+      for n <- all_nurses, d <- all_days do
+        Constraint.new(sum(for s <- all_shifts, do: shift.(n, d, s)) <= 1)
+      end
+
+    min_shifts = div(Enum.count(all_shifts) * Enum.count(all_days), Enum.count(all_nurses))
+
+    distribution =
+      Enum.flat_map(all_nurses, fn n ->
+        vars = for d <- all_days, s <- all_shifts, do: shift.(n, d, s)
+        [Constraint.new(min_shifts <= sum(vars)), Constraint.new(sum(vars) <= min_shifts + 1)]
+      end)
+
+    requested =
+      for n <- all_nurses, d <- all_days, s <- all_shifts do
+        request = shift_requests |> Enum.at(n - 1) |> Enum.at(d - 1) |> Enum.at(s - 1)
+        LinearExpression.prod(shift.(n, d, s), request)
+      end
+
+    Builder.new()
+    |> Builder.add(shift_vars)
+    |> Builder.add(one_nurse_per_shift)
+    |> Builder.add(one_shift_per_day)
+    |> Builder.add(distribution)
+    |> Builder.maximize(sum(requested))
+  end
+
+  @doc """
+  The `{weight, value}` of each item of `knapsack/0`.
+  """
+  def knapsack_items do
+    weights = [48, 30, 42, 36, 36, 48, 42, 42, 36, 24, 30, 30, 42, 36, 36]
+    values = [10, 30, 25, 50, 35, 30, 15, 40, 30, 35, 45, 10, 20, 30, 25]
+    Enum.zip(weights, values)
+  end
+
+  def knapsack do
+    capacities = [100, 100, 100, 100, 100]
+    items = Enum.with_index(knapsack_items())
+    bins = Enum.with_index(capacities)
+
+    x = fn item, bin -> "x_#{item}_#{bin}" end
+
+    vars = for {_, item} <- items, {_, bin} <- bins, do: BoolVar.new(x.(item, bin))
+
+    once =
+      for {_, item} <- items do
+        Constraint.new(sum(for {_, bin} <- bins, do: x.(item, bin)) <= 1)
+      end
+
+    capacity =
+      for {capacity, bin} <- bins do
+        load = for {{weight, _}, item} <- items, do: LinearExpression.prod(x.(item, bin), weight)
+        Constraint.new(sum(load) <= capacity)
+      end
+
+    value =
+      for {_, bin} <- bins, {{_, value}, item} <- items do
+        LinearExpression.prod(x.(item, bin), value)
+      end
+
+    Builder.new()
+    |> Builder.add(vars)
+    |> Builder.add(once)
+    |> Builder.add(capacity)
+    |> Builder.maximize(sum(value))
+  end
+
+  def bin_packing do
+    bin_capacity = 100
+    safe_capacity = 80
+    all_bins = 1..5
+    items = [{20, 6}, {15, 6}, {30, 4}, {45, 3}]
+
+    xs = for {item, copies} <- items, bin <- all_bins, do: IntVar.new("x_#{item}_#{bin}", {0, copies})
+    loads = for bin <- all_bins, do: IntVar.new("load_#{bin}", {0, bin_capacity})
+    slacks = for bin <- all_bins, do: BoolVar.new("slack_#{bin}")
+
+    load_constraints =
+      for bin <- all_bins do
+        load = for {item, _} <- items, do: LinearExpression.prod("x_#{item}_#{bin}", item)
+        Constraint.new(sum(load) == "load_#{bin}")
+      end
+
+    placements =
+      for {item, copies} <- items do
+        Constraint.new(sum(for bin <- all_bins, do: "x_#{item}_#{bin}") == copies)
+      end
+
+    slack_constraints =
+      Enum.flat_map(all_bins, fn bin ->
+        load_bin = "load_#{bin}"
+        slack_bin = "slack_#{bin}"
+
+        [
+          Constraint.new(load_bin <= safe_capacity, if: slack_bin),
+          Constraint.new(load_bin > safe_capacity, unless: slack_bin)
+        ]
+      end)
+
+    Builder.new()
+    |> Builder.add(xs)
+    |> Builder.add(loads)
+    |> Builder.add(slacks)
+    |> Builder.add(load_constraints)
+    |> Builder.add(placements)
+    |> Builder.add(slack_constraints)
+    |> Builder.maximize(sum(for bin <- all_bins, do: "slack_#{bin}"))
+  end
+
+  @doc """
+  A Golomb ruler with 11 marks within 70. A ruler with 11 marks is at least 72
+  long, which takes far longer to prove than the tests run, and no solution is
+  ever found.
+  """
+  def golomb_ruler do
+    marks = for i <- 0..10, do: "m#{i}"
+
+    builder =
+      Enum.reduce(marks, Builder.new(), &Builder.def_int_var(&2, &1, {0, 70}))
+      |> Builder.constrain("m0" == 0)
+
+    builder =
+      marks
+      |> Enum.zip(tl(marks))
+      |> Enum.reduce(builder, fn {a, b}, builder -> Builder.constrain(builder, a < b) end)
+
+    differences =
+      for {a, i} <- Enum.with_index(marks), {b, j} <- Enum.with_index(marks), i < j do
+        LinearExpression.minus(b, a)
+      end
+
+    Builder.constrain_list(builder, :"all!=", differences)
+  end
+
+  @doc """
+  A travelling salesman tour of `points`, `[{x, y}]`, with the circuit
+  constraint. Arc `{i, j}` is used when `"x_i_j"` is true.
+  """
+  def routing_circuit(points) do
+    arcs = routing_arcs(length(points))
+
+    points
+    |> routing_builder()
+    |> Builder.constrain_list(:circuit, for({i, j} <- arcs, do: {i, j, "x_#{i}_#{j}"}))
+  end
+
+  @doc """
+  The tour of `routing_circuit/1` with the Miller-Tucker-Zemlin linear
+  encoding the circuit constraint replaces: each node is entered and left
+  once, and the ordering `u` of the nodes other than the depot, node 0, rules
+  out subtours.
+  """
+  def routing_mtz(points) do
+    n = length(points)
+    arcs = routing_arcs(n)
+    bound = n - 1
+
+    degrees =
+      Enum.flat_map(0..(n - 1), fn node ->
+        leaving = for {^node, j} <- arcs, do: "x_#{node}_#{j}"
+        entering = for {i, ^node} <- arcs, do: "x_#{i}_#{node}"
+        [Constraint.new(sum(leaving) == 1), Constraint.new(sum(entering) == 1)]
+      end)
+
+    order = for node <- 1..(n - 1), do: IntVar.new("u_#{node}", {1, n - 1})
+
+    subtours =
+      for {i, j} <- arcs, i != 0 and j != 0 do
+        Constraint.new("u_#{i}" - "u_#{j}" + n * "x_#{i}_#{j}" <= bound)
+      end
+
+    points
+    |> routing_builder()
+    |> Builder.add(degrees)
+    |> Builder.add(order)
+    |> Builder.add(subtours)
+  end
+
+  @doc """
+  The arcs `{i, j}` between `n` nodes.
+  """
+  def routing_arcs(n) do
+    for i <- 0..(n - 1), j <- 0..(n - 1), i != j, do: {i, j}
+  end
+
+  # The arc variables, minimizing the Manhattan length of the arcs used.
+  defp routing_builder(points) do
+    points = List.to_tuple(points)
+    arcs = routing_arcs(tuple_size(points))
+
+    distance =
+      for {i, j} <- arcs do
+        {xi, yi} = elem(points, i)
+        {xj, yj} = elem(points, j)
+        LinearExpression.prod("x_#{i}_#{j}", abs(xi - xj) + abs(yi - yj))
+      end
+
+    Builder.new()
+    |> Builder.add(for {i, j} <- arcs, do: BoolVar.new("x_#{i}_#{j}"))
+    |> Builder.minimize(sum(distance))
+  end
+end
@@ -1 +1,2 @@
-ExUnit.start()
+# The distributed tests start peer nodes and need epmd: `mix test --include distributed`.
+ExUnit.start(exclude: [:distributed])